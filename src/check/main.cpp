@@ -0,0 +1,131 @@
+/**
+ * @file main.cpp
+ * @brief C++20 compile check for headers no other build instantiates.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * @details
+ * Built by `make check`, which `make test` runs first. The library builds
+ * as C++17, where `__cpp_impl_coroutine` is not defined and
+ * signal_coro.hpp compiles to nothing. This file is compiled as C++20 with
+ * the project's warning flags so `co_await handler.next(set)` is
+ * instantiated on every build. The header-only `StaticSignalHandler` is
+ * instantiated here too, since neither the demo nor the library uses it.
+ * It is only compiled, never linked or run.
+ */
+
+// Project libraries
+#include "../signal_handler.hpp"
+#include "../signal_static.hpp"
+
+// Standard Libraries
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+
+#ifndef __cpp_impl_coroutine
+#error "check/main.cpp must be compiled with coroutine support (-std=c++20)"
+#endif
+
+/**
+ * @brief Minimal eager, fire-and-forget coroutine type.
+ */
+struct CheckTask
+{
+    struct promise_type
+    {
+        CheckTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * @brief Executor that resumes the coroutine in place, as a custom executor would.
+ */
+struct CheckExecutor
+{
+    void post(std::coroutine_handle<> handle)
+    {
+        handle.resume();
+    }
+};
+
+/**
+ * @brief Waits for SIGUSR2 with the inline and with a custom executor.
+ *
+ * @param h The handler to wait on.
+ * @param ex The executor for the second await.
+ * @return The coroutine.
+ */
+static CheckTask awaitSignals(SignalHandler &h, CheckExecutor &ex)
+{
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR2);
+
+    for (;;)
+    {
+        siginfo_t inline_info = co_await h.next(set);
+        if (inline_info.si_signo == 0)
+            co_return;
+
+        siginfo_t posted_info = co_await h.next(set, &ex);
+        if (posted_info.si_signo == 0)
+            co_return;
+    }
+}
+
+/**
+ * @brief `StaticSignalHandler` policy: one overload and one catch-all template.
+ */
+struct CheckHandlers
+{
+    std::atomic<int> *reloads;
+    std::atomic<bool> *stop;
+
+    void operator()(std::integral_constant<int, SIGHUP>, const siginfo_t &)
+    {
+        reloads->fetch_add(1);
+    }
+
+    template <int Sig>
+    void operator()(std::integral_constant<int, Sig>, const siginfo_t &)
+    {
+        stop->store(true);
+    }
+};
+
+/**
+ * @brief The compile-time set checked here.
+ */
+using CheckStaticHandler = StaticSignalHandler<CheckHandlers, SIGINT, SIGTERM, SIGHUP>;
+
+static_assert(CheckStaticHandler::handles(SIGHUP) && !CheckStaticHandler::handles(SIGUSR1),
+              "StaticSignalHandler jump table does not match its set");
+static_assert(CheckStaticHandler::signal_limit == SIGTERM + 1,
+              "StaticSignalHandler signal_limit is not one past the highest signal");
+
+int main()
+{
+    SignalHandler handler;
+    CheckExecutor executor;
+    handler.watchSignal(SIGUSR2);
+    awaitSignals(handler, executor);
+
+    std::atomic<int> reloads{0};
+    std::atomic<bool> stop{false};
+    CheckStaticHandler signals(CheckHandlers{&reloads, &stop});
+    signals.start();
+    siginfo_t info{};
+    info.si_signo = SIGHUP;
+    signals.dispatch(info);
+    signals.stop();
+    return 0;
+}
@@ -15,15 +15,17 @@
  * Features:
  * - Blocks signals in the main thread and all spawned worker threads.
  * - Starts a dedicated signal-handling thread to catch and respond to signals.
- * - Demonstrates thread synchronization using condition variables.
+ * - Workers observe the handler's stop token instead of a mutex and
+ *   condition variable.
+ * - Workers are joined by parallel drain hooks with a deadline; a second
+ *   SIGINT or SIGTERM during shutdown forces an exit.
  */
 
 #include "signal_handler.hpp"
 
 #include <iostream>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
+#include <chrono>
 #include <vector>
 #include <unistd.h>
 
@@ -34,11 +36,6 @@
 /// Global unique instance of SignalHandler.
 SignalHandler signalHandler;
 
-/// Controls thread synchronization and shutdown.
-std::mutex cv_mutex;
-std::condition_variable cv;
-std::atomic<bool> stop_requested{false};
-
 // -----------------------------------------------------------------------------
 // Signal Callback
 // -----------------------------------------------------------------------------
@@ -47,8 +44,8 @@ std::atomic<bool> stop_requested{false};
  * @brief Signal handler callback registered with SignalHandler.
  *
  * @details
- * Triggered when a signal is received. Logs the signal and sets the
- * `stop_requested` flag, then notifies all waiting threads.
+ * Triggered when a signal is received. The handler has already triggered
+ * its stop token for non-immediate signals, so this only logs.
  *
  * @param signum The signal number received.
  * @param critical Whether the signal is marked as critical (unused here).
@@ -57,13 +54,6 @@ void signal_handler(int signum, bool critical = false)
 {
     std::cout << "Caught signal " << SignalHandler::signalToString(signum)
               << ", stopping gracefully." << std::endl;
-
-    {
-        std::lock_guard<std::mutex> lock(cv_mutex);
-        stop_requested.store(true);
-    }
-
-    cv.notify_all(); // Wake up any waiting worker threads.
 }
 
 // -----------------------------------------------------------------------------
@@ -71,15 +61,18 @@ void signal_handler(int signum, bool critical = false)
 // -----------------------------------------------------------------------------
 
 /**
- * @brief Simulated worker thread that waits until stop is requested.
+ * @brief Simulated worker thread that runs until a stop is requested.
+ *
+ * @details
+ * The hot path is a single load of the handler's cache-line-aligned stop
+ * token; no lock is shared between workers. Between bursts of work the
+ * thread sleeps on the token's futex, so a stop wakes it immediately.
  *
- * @param id The thread's unique ID (unused in this example).
+ * @param token The handler's stop token.
  */
-void worker_thread(int id)
+void worker_thread(SignalStopToken token)
 {
-    std::unique_lock<std::mutex> lock(cv_mutex);
-
-    while (!stop_requested.load())
+    while (!token.stopRequested())
     {
         // Simulate computation or I/O
         for (volatile int i = 0; i < 1000000; ++i)
@@ -87,9 +80,8 @@ void worker_thread(int id)
             // Intentional no-op to simulate work
         }
 
-        // Periodically check for stop condition with timeout
-        cv.wait_for(lock, std::chrono::milliseconds(100), []
-                    { return stop_requested.load(); });
+        // Idle until the next burst of work or a stop request
+        token.waitFor(std::chrono::milliseconds(100));
     }
 }
 
@@ -104,39 +96,57 @@ void worker_thread(int id)
  */
 int main()
 {
-    // Block signals globally before spawning threads
+    // Report faults from the faulting thread, then block the rest globally
+    SignalCrashHandler::install();
     block_signals();
 
     // Set up signal handling
     signalHandler.setCallback(signal_handler);
+
+    // Logging is slow; keep it off the thread that receives signals
+    signalHandler.enableDispatchPool(1);
+    for (int sig = 1; sig < SignalHandler::signal_limit; ++sig)
+    {
+        signalHandler.setDispatchPolicy(sig, SignalHandler::DispatchPolicy::Serialized);
+    }
+
+    // Name and prioritize the signal thread from its first instruction
+    SignalHandler::ThreadOptions options;
+    options.name = "signals";
+    options.policy = SCHED_RR;
+    options.priority = 10;
+    options.stack_size = 64 * 1024;
+    signalHandler.setThreadOptions(options);
     signalHandler.start();
-    signalHandler.setPriority(SCHED_RR, 10);
 
     // Launch worker threads to simulate background activity
     std::vector<std::thread> workers;
     const int num_workers = 4;
     for (int i = 0; i < num_workers; ++i)
     {
-        workers.emplace_back(worker_thread, i);
+        workers.emplace_back(worker_thread, signalHandler.getStopToken());
     }
 
-    // Wait until a stop is requested via signal
+    // Join the workers in parallel during the drain phase, within 5 seconds
+    for (auto &worker : workers)
     {
-        std::unique_lock<std::mutex> lock(cv_mutex);
-        cv.wait(lock, []
-                { return stop_requested.load(); });
+        signalHandler.shutdown().addHook(SignalShutdown::Phase::Drain, "worker",
+                                         [&worker](const SignalStopToken &)
+                                         { worker.join(); });
     }
+    signalHandler.shutdown().setDeadline(SignalShutdown::Phase::Drain, std::chrono::seconds(5));
 
-    // Shut down the signal handler
-    signalHandler.stop();
+    // Wait until a stop is requested via signal
+    signalHandler.getStopToken().wait();
+
+    // Starts the phases if the signal beat the hooks above, otherwise a no-op
+    signalHandler.requestStop();
 
     std::cout << "Waiting for worker threads to finish." << std::endl;
+    signalHandler.shutdown().wait();
 
-    // Join all worker threads
-    for (auto &worker : workers)
-    {
-        worker.join();
-    }
+    // Shut down the signal handler
+    signalHandler.stop();
 
     std::cout << "All threads stopped. Exiting." << std::endl;
     return 0;
@@ -0,0 +1,267 @@
+/**
+ * @file signal_backtrace.cpp
+ * @brief Captures the stack of another thread with a directed real-time signal.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_backtrace.hpp"
+
+// Standard libraries
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// System libraries
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Frames at the top of a capture that belong to `onCapture()` and
+ *        the kernel's signal return trampoline.
+ */
+static constexpr int handler_frames = 2;
+
+/**
+ * @brief Low bits of `capture_state`: what the current request is doing.
+ */
+static constexpr std::uint64_t state_idle = 0;
+static constexpr std::uint64_t state_requested = 1;
+static constexpr std::uint64_t state_writing = 2;
+static constexpr std::uint64_t state_done = 3;
+
+/**
+ * @brief The claimed capture signal, 0 until `enable()` succeeds.
+ */
+static std::atomic<int> capture_signal{0};
+
+/**
+ * @brief Serializes `enable()` and `capture()` callers.
+ */
+static std::mutex capture_mutex;
+
+/**
+ * @brief Request number in the high bits, state in the low two.
+ */
+static std::atomic<std::uint64_t> capture_state{0};
+
+/**
+ * @brief Number of the last request sent.
+ */
+static std::uint64_t capture_request = 0;
+
+/**
+ * @brief Frames written by the handler for the current request.
+ */
+static void *capture_frames[SignalBacktrace::max_frames + handler_frames];
+
+/**
+ * @brief Number of valid entries in `capture_frames`.
+ */
+static int capture_depth = 0;
+
+/**
+ * @brief Claims the capture signal.
+ *
+ * @return `true` once a signal is claimed.
+ */
+bool SignalBacktrace::enable()
+{
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    if (capture_signal.load() != 0)
+    {
+        return true;
+    }
+
+    void *warmup[2];
+    backtrace(warmup, 2);
+
+    for (int sig = SIGRTMAX; sig >= SIGRTMIN; --sig)
+    {
+        struct sigaction current;
+        if (sigaction(sig, nullptr, &current) != 0 || current.sa_handler != SIG_DFL)
+        {
+            continue;
+        }
+
+        struct sigaction sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = &SignalBacktrace::onCapture;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(sig, &sa, nullptr) == 0)
+        {
+            capture_signal.store(sig);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the claimed capture signal.
+ *
+ * @return The signal, or 0.
+ */
+int SignalBacktrace::signal()
+{
+    return capture_signal.load();
+}
+
+/**
+ * @brief Captures a thread's stack.
+ *
+ * @details
+ * On timeout the request is withdrawn with a compare-and-swap. If that
+ * fails the handler has already started writing, so the caller waits the
+ * few microseconds `backtrace()` takes and uses the result after all.
+ *
+ * @param tid The thread.
+ * @param frames Output array.
+ * @param capacity Its size.
+ * @param timeout Maximum wait.
+ * @return The frame count, or -1.
+ */
+int SignalBacktrace::capture(pid_t tid, void **frames, int capacity, std::chrono::milliseconds timeout)
+{
+    if (capacity <= 0)
+    {
+        return -1;
+    }
+    if (capacity > max_frames)
+    {
+        capacity = max_frames;
+    }
+
+    if (tid == static_cast<pid_t>(syscall(SYS_gettid)))
+    {
+        // Leave out this function's own frame
+        void *own[max_frames + 1];
+        int depth = backtrace(own, capacity + 1) - 1;
+        if (depth <= 0)
+        {
+            return 0;
+        }
+        std::memcpy(frames, own + 1, static_cast<std::size_t>(depth) * sizeof(void *));
+        return depth;
+    }
+
+    std::lock_guard<std::mutex> lock(capture_mutex);
+    int sig = capture_signal.load();
+    if (sig == 0)
+    {
+        return -1;
+    }
+
+    std::uint64_t request = ++capture_request;
+    std::uint64_t requested = (request << 2) | state_requested;
+    capture_state.store(requested);
+
+    siginfo_t info;
+    std::memset(&info, 0, sizeof(info));
+    info.si_signo = sig;
+    info.si_code = SI_QUEUE;
+    info.si_pid = getpid();
+    info.si_uid = getuid();
+    info.si_value.sival_ptr = reinterpret_cast<void *>(static_cast<std::uintptr_t>(request));
+    if (syscall(SYS_rt_tgsigqueueinfo, getpid(), tid, sig, &info) != 0)
+    {
+        capture_state.store(state_idle);
+        return -1;
+    }
+
+    std::uint64_t done = (request << 2) | state_done;
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (capture_state.load(std::memory_order_acquire) != done)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            std::uint64_t expected = requested;
+            if (capture_state.compare_exchange_strong(expected, state_idle))
+            {
+                return -1;
+            }
+            // Already writing; it finishes shortly
+            while (capture_state.load(std::memory_order_acquire) != done)
+            {
+                std::this_thread::yield();
+            }
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    int depth = capture_depth - handler_frames;
+    if (depth < 0)
+    {
+        depth = 0;
+    }
+    if (depth > capacity)
+    {
+        depth = capacity;
+    }
+    std::memcpy(frames, capture_frames + handler_frames, static_cast<std::size_t>(depth) * sizeof(void *));
+    capture_state.store(state_idle);
+    return depth;
+}
+
+/**
+ * @brief Fills the shared buffer if the request is still current.
+ *
+ * @details Async-signal-safe once `backtrace()` has been warmed up.
+ * `errno` is preserved.
+ *
+ * @param sig The capture signal.
+ * @param info The request.
+ * @param context Unused.
+ */
+void SignalBacktrace::onCapture(int sig, siginfo_t *info, void *context)
+{
+    (void)sig;
+    (void)context;
+
+    // Only our own requests carry a number
+    if (info == nullptr || info->si_code != SI_QUEUE || info->si_pid != getpid())
+    {
+        return;
+    }
+
+    std::uint64_t request = static_cast<std::uint64_t>(
+        reinterpret_cast<std::uintptr_t>(info->si_value.sival_ptr));
+    std::uint64_t expected = (request << 2) | state_requested;
+    if (!capture_state.compare_exchange_strong(expected, (request << 2) | state_writing))
+    {
+        return; // Withdrawn, or a stale request
+    }
+
+    int saved_errno = errno;
+    capture_depth = backtrace(capture_frames, SignalBacktrace::max_frames + handler_frames);
+    capture_state.store((request << 2) | state_done, std::memory_order_release);
+    errno = saved_errno;
+}
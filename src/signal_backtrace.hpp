@@ -0,0 +1,111 @@
+/**
+ * @file signal_backtrace.hpp
+ * @brief Captures the stack of another thread with a directed real-time signal.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_BACKTRACE_HPP
+#define SIGNAL_BACKTRACE_HPP
+
+// Standard Libraries
+#include <chrono>
+#include <csignal>
+
+// System libraries
+#include <sys/types.h>
+
+/**
+ * @brief Captures any thread's stack from any other thread.
+ *
+ * @details
+ * `enable()` claims one free real-time signal for the process and installs
+ * a capture handler on it. `capture()` queues that signal to the target
+ * thread alone with `rt_tgsigqueueinfo()`. The handler runs on the target,
+ * calls `backtrace()` into a preallocated buffer, and the caller copies the
+ * frames out.
+ *
+ * Captures are serialized and share one buffer, guarded by a small state
+ * word: requested, writing or done, tagged with a request number. A
+ * handler that arrives after its caller gave up finds a stale number and
+ * writes nothing, so a late answer can never corrupt a later capture.
+ *
+ * A thread with the signal blocked, or stuck in an uninterruptible sleep,
+ * cannot answer and the capture times out. The handler uses SA_RESTART,
+ * but like any handled signal a capture cuts short calls the kernel never
+ * restarts, such as `nanosleep()`, which return early with EINTR.
+ */
+class SignalBacktrace
+{
+public:
+    /**
+     * @brief Maximum frames per capture.
+     */
+    static constexpr int max_frames = 64;
+
+    SignalBacktrace() = delete;
+
+    /**
+     * @brief Claims the capture signal; safe to call repeatedly.
+     *
+     * @details Searches down from `SIGRTMAX` for a signal still at SIG_DFL,
+     * and calls `backtrace()` once so libgcc is loaded before it is needed
+     * in signal context.
+     *
+     * @return false if no real-time signal was free.
+     */
+    static bool enable();
+
+    /**
+     * @brief Returns the claimed capture signal.
+     *
+     * @return The signal number, or 0 before `enable()`.
+     */
+    static int signal();
+
+    /**
+     * @brief Captures a thread's stack.
+     *
+     * @param tid Kernel thread ID in this process; the calling thread is
+     *            captured directly.
+     * @param frames Receives the return addresses, innermost first.
+     * @param capacity Size of `frames`; at most `max_frames` are used.
+     * @param timeout How long to wait for the thread to answer.
+     * @return The number of frames, or -1 if not enabled, the thread could
+     *         not be signalled or did not answer in time.
+     */
+    static int capture(pid_t tid, void **frames, int capacity, std::chrono::milliseconds timeout);
+
+private:
+    /**
+     * @brief Runs on the target thread; fills the shared buffer.
+     *
+     * @param sig The capture signal.
+     * @param info Carries the request number in `si_value`.
+     * @param context Unused.
+     */
+    static void onCapture(int sig, siginfo_t *info, void *context);
+};
+
+#endif // SIGNAL_BACKTRACE_HPP
@@ -0,0 +1,450 @@
+/**
+ * @file signal_child.cpp
+ * @brief Batched SIGCHLD reaping with per-pid exit handlers and pidfd support.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_child.hpp"
+
+// Standard libraries
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+// System libraries
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief `waitid()` id type for a pidfd (Linux 5.4+), missing from older glibc.
+ */
+#ifdef P_PIDFD
+static constexpr idtype_t pidfd_idtype = P_PIDFD;
+#else
+static constexpr idtype_t pidfd_idtype = static_cast<idtype_t>(3);
+#endif
+
+/**
+ * @brief Initial number of table slots.
+ */
+static constexpr std::size_t initial_slots = 64;
+
+/**
+ * @brief Maps a pid to its home slot.
+ *
+ * @param pid The key.
+ * @param mask Slot count minus one.
+ * @return The home slot index.
+ */
+static std::size_t slotFor(pid_t pid, std::size_t mask)
+{
+    // Fibonacci hashing spreads sequential pids across the table
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(pid) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+/**
+ * @brief Constructs an empty reaper.
+ */
+SignalChildReaper::SignalChildReaper()
+    : slots(initial_slots),
+      live(0),
+      used(0),
+      reaped_count(0)
+{
+}
+
+/**
+ * @brief Registers the handler for one child's exit.
+ *
+ * @param pid The child.
+ * @param handler Called once when it exits.
+ * @return `true` if registered or completed from a remembered exit.
+ */
+bool SignalChildReaper::watch(pid_t pid, ExitHandler handler)
+{
+    if (pid <= 0 || !handler)
+    {
+        return false;
+    }
+
+    Exit early;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (find(pid) >= 0)
+        {
+            return false;
+        }
+
+        // The child may have been reaped between fork() and this call
+        bool found = false;
+        for (auto it = unmatched.begin(); it != unmatched.end(); ++it)
+        {
+            if (it->pid == pid)
+            {
+                early = *it;
+                unmatched.erase(it);
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            insert(pid, std::move(handler));
+            return true;
+        }
+    }
+
+    handler(early);
+    return true;
+}
+
+/**
+ * @brief Registers the handler and opens a pidfd for one child.
+ *
+ * @param pid The child.
+ * @param handler Called once when it exits.
+ * @return The pidfd, or -1 on failure (the handler is not registered then).
+ */
+int SignalChildReaper::watchPidfd(pid_t pid, ExitHandler handler)
+{
+#ifdef SYS_pidfd_open
+    int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (fd < 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("pidfd_open");
+#endif
+        return -1;
+    }
+
+    // pidfd_open() sets O_CLOEXEC itself
+    if (!watch(pid, std::move(handler)))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    (void)pid;
+    (void)handler;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Collects the child behind a readable pidfd.
+ *
+ * @details `WNOHANG` makes a spurious wakeup harmless. `ECHILD` means the
+ * SIGCHLD path already reaped the child and ran its handler. The pidfd is
+ * closed in every case.
+ *
+ * @param pidfd A descriptor from `watchPidfd()`.
+ * @return `true` if a child was reaped here.
+ */
+bool SignalChildReaper::reapPidfd(int pidfd)
+{
+    if (pidfd < 0)
+    {
+        return false;
+    }
+
+    siginfo_t info;
+    std::memset(&info, 0, sizeof(info));
+    int ret = waitid(pidfd_idtype, static_cast<id_t>(pidfd), &info, WEXITED | WNOHANG);
+    close(pidfd);
+
+    if (ret != 0 || info.si_pid == 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        if (ret != 0 && errno != ECHILD)
+        {
+            perror("waitid(P_PIDFD)");
+        }
+#endif
+        return false;
+    }
+
+    Exit exit = toExit(info);
+    ExitHandler handler = claim(exit);
+    if (handler)
+    {
+        handler(exit);
+    }
+    return true;
+}
+
+/**
+ * @brief Removes a handler before the child exits.
+ *
+ * @param pid The child.
+ * @return `true` if a handler was removed.
+ */
+bool SignalChildReaper::unwatch(pid_t pid)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    long i = find(pid);
+    if (i < 0)
+    {
+        return false;
+    }
+
+    slots[i].pid = tombstone_pid;
+    slots[i].handler = nullptr;
+    --live;
+    return true;
+}
+
+/**
+ * @brief Sets the handler for unwatched exits.
+ *
+ * @param handler The handler, or empty to remember exits.
+ */
+void SignalChildReaper::setDefaultHandler(ExitHandler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    default_handler = std::move(handler);
+    if (default_handler)
+    {
+        unmatched.clear();
+    }
+}
+
+/**
+ * @brief Reaps every exited child.
+ *
+ * @details
+ * Loops on `waitid(P_ALL, WEXITED | WNOHANG)` until it reports no more
+ * exited children (`si_pid` 0) or no children at all (`ECHILD`). Each exit
+ * is dispatched as it is reaped, outside the lock.
+ *
+ * @return The number of children reaped.
+ */
+std::size_t SignalChildReaper::reap()
+{
+    std::size_t count = 0;
+    while (true)
+    {
+        siginfo_t info;
+        std::memset(&info, 0, sizeof(info));
+        if (waitid(P_ALL, 0, &info, WEXITED | WNOHANG) != 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+#ifdef DEBUG_SIGNAL_HANDLER
+            if (errno != ECHILD)
+            {
+                perror("waitid");
+            }
+#endif
+            break;
+        }
+
+        if (info.si_pid == 0)
+        {
+            break; // Children remain, none of them exited
+        }
+
+        ++count;
+        Exit exit = toExit(info);
+        ExitHandler handler = claim(exit);
+        if (handler)
+        {
+            handler(exit);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Returns the number of children being watched.
+ *
+ * @return The handler count.
+ */
+std::size_t SignalChildReaper::watched() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return live;
+}
+
+/**
+ * @brief Returns the total number of children reaped.
+ *
+ * @return The count.
+ */
+std::uint64_t SignalChildReaper::reaped() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return reaped_count;
+}
+
+/**
+ * @brief Finds the slot holding `pid`.
+ *
+ * @param pid The key.
+ * @return The slot index, or -1.
+ */
+long SignalChildReaper::find(pid_t pid) const
+{
+    std::size_t mask = slots.size() - 1;
+    for (std::size_t i = slotFor(pid, mask);; i = (i + 1) & mask)
+    {
+        if (slots[i].pid == pid)
+        {
+            return static_cast<long>(i);
+        }
+        if (slots[i].pid == empty_pid)
+        {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Inserts a handler.
+ *
+ * @details Keeps occupied slots, tombstones included, under 3/4 of the
+ * table so probe chains stay short and always end in an empty slot.
+ *
+ * @param pid The key.
+ * @param handler The handler.
+ */
+void SignalChildReaper::insert(pid_t pid, ExitHandler handler)
+{
+    if ((used + 1) * 4 > slots.size() * 3)
+    {
+        // Grow only if live entries need it, otherwise just clear tombstones
+        std::size_t capacity = slots.size();
+        if ((live + 1) * 2 > capacity)
+        {
+            capacity *= 2;
+        }
+        rehash(capacity);
+    }
+
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = slotFor(pid, mask);
+    while (slots[i].pid != empty_pid && slots[i].pid != tombstone_pid)
+    {
+        i = (i + 1) & mask;
+    }
+
+    if (slots[i].pid == empty_pid)
+    {
+        ++used;
+    }
+    slots[i].pid = pid;
+    slots[i].handler = std::move(handler);
+    ++live;
+}
+
+/**
+ * @brief Rebuilds the table without tombstones.
+ *
+ * @param capacity The new slot count.
+ */
+void SignalChildReaper::rehash(std::size_t capacity)
+{
+    std::vector<Slot> old(capacity);
+    old.swap(slots);
+    live = 0;
+    used = 0;
+
+    std::size_t mask = capacity - 1;
+    for (Slot &slot : old)
+    {
+        if (slot.pid == empty_pid || slot.pid == tombstone_pid)
+        {
+            continue;
+        }
+
+        std::size_t i = slotFor(slot.pid, mask);
+        while (slots[i].pid != empty_pid)
+        {
+            i = (i + 1) & mask;
+        }
+        slots[i].pid = slot.pid;
+        slots[i].handler = std::move(slot.handler);
+        ++live;
+        ++used;
+    }
+}
+
+/**
+ * @brief Takes the handler for an exit, or remembers the exit.
+ *
+ * @param exit The exit.
+ * @return The watched or default handler, or empty.
+ */
+SignalChildReaper::ExitHandler SignalChildReaper::claim(const Exit &exit)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++reaped_count;
+
+    long i = find(exit.pid);
+    if (i >= 0)
+    {
+        ExitHandler handler = std::move(slots[i].handler);
+        slots[i].pid = tombstone_pid;
+        slots[i].handler = nullptr;
+        --live;
+        return handler;
+    }
+
+    if (default_handler)
+    {
+        return default_handler;
+    }
+
+    // Keep it for a watch() that has not happened yet
+    if (unmatched.size() == max_unmatched)
+    {
+        unmatched.pop_front();
+    }
+    unmatched.push_back(exit);
+    return nullptr;
+}
+
+/**
+ * @brief Converts `waitid()` output.
+ *
+ * @param info The result.
+ * @return The exit.
+ */
+SignalChildReaper::Exit SignalChildReaper::toExit(const siginfo_t &info)
+{
+    Exit exit;
+    exit.pid = info.si_pid;
+    exit.uid = info.si_uid;
+    exit.code = info.si_code;
+    exit.status = info.si_status;
+    return exit;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file signal_child.hpp
+ * @brief Batched SIGCHLD reaping with per-pid exit handlers and pidfd support.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_CHILD_HPP
+#define SIGNAL_CHILD_HPP
+
+// Standard Libraries
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// System libraries
+#include <sys/types.h>
+
+/**
+ * @brief Reaps exited children and routes each exit to its handler.
+ *
+ * @details
+ * `reap()` drains every exited child in one pass with
+ * `waitid(P_ALL, WEXITED | WNOHANG)`, so a single SIGCHLD wakeup (SIGCHLD
+ * coalesces, one may stand for many exits) costs one system call per child
+ * plus one to find the queue empty. Bound with
+ * `SignalHandler::enableChildReaping()` it runs on the signal thread.
+ *
+ * Handlers are kept in an open-addressing hash table keyed by pid, so a
+ * lookup is a multiply and, usually, one probe, with no per-entry
+ * allocation beyond the handler itself. A child that exits before `watch()`
+ * is called for it (the fork/register race) is remembered, and `watch()`
+ * then completes at once. Exits nobody watches go to the default handler
+ * if one is set.
+ *
+ * For epoll loops, `watchPidfd()` also returns a pidfd that becomes
+ * readable when the child exits; `reapPidfd()` then collects that child
+ * alone, with no SIGCHLD involved.
+ *
+ * Handlers are called without the table lock held and may call `watch()`.
+ */
+class SignalChildReaper
+{
+public:
+    /**
+     * @brief How a child exited.
+     */
+    struct Exit
+    {
+        pid_t pid = 0;   ///< The child's pid.
+        uid_t uid = 0;   ///< Its real user ID.
+        int code = 0;    ///< CLD_EXITED, CLD_KILLED or CLD_DUMPED.
+        int status = 0;  ///< Exit status, or the terminating signal.
+    };
+
+    /**
+     * @brief Called once with a child's exit.
+     */
+    using ExitHandler = std::function<void(const Exit &exit)>;
+
+    /**
+     * @brief Maximum number of unwatched exits remembered for a late `watch()`.
+     */
+    static constexpr std::size_t max_unmatched = 256;
+
+    SignalChildReaper();
+
+    // Handlers refer to this object
+    SignalChildReaper(const SignalChildReaper &) = delete;
+    SignalChildReaper &operator=(const SignalChildReaper &) = delete;
+
+    /**
+     * @brief Registers the handler for one child's exit.
+     *
+     * @details If the child has already been reaped, `handler` is called
+     * before this returns.
+     *
+     * @param pid The child.
+     * @param handler Called once when it exits.
+     * @return false for an invalid pid or empty handler, or if already watched.
+     */
+    bool watch(pid_t pid, ExitHandler handler);
+
+    /**
+     * @brief Registers the handler and opens a pidfd for one child.
+     *
+     * @details The pidfd is close-on-exec and becomes readable (EPOLLIN)
+     * when the child exits; pass it to `reapPidfd()` then. If SIGCHLD
+     * reaping collects the child first, the handler still runs once and
+     * `reapPidfd()` just closes the descriptor.
+     *
+     * @param pid The child.
+     * @param handler Called once when it exits.
+     * @return The pidfd, or -1 if pidfds are unsupported or on error.
+     */
+    int watchPidfd(pid_t pid, ExitHandler handler);
+
+    /**
+     * @brief Collects the child behind a readable pidfd and closes the pidfd.
+     *
+     * @param pidfd A descriptor from `watchPidfd()`.
+     * @return true if a child was reaped.
+     */
+    bool reapPidfd(int pidfd);
+
+    /**
+     * @brief Removes a handler before the child exits.
+     *
+     * @param pid The child.
+     * @return true if a handler was removed.
+     */
+    bool unwatch(pid_t pid);
+
+    /**
+     * @brief Sets the handler for exits nobody watches.
+     *
+     * @details With a default handler set, unwatched exits are no longer
+     * remembered for a late `watch()`.
+     *
+     * @param handler The handler; empty to remember exits instead.
+     */
+    void setDefaultHandler(ExitHandler handler);
+
+    /**
+     * @brief Reaps every exited child and dispatches their exits.
+     *
+     * @return The number of children reaped.
+     */
+    std::size_t reap();
+
+    /**
+     * @brief Returns the number of children being watched.
+     *
+     * @return The handler count.
+     */
+    std::size_t watched() const;
+
+    /**
+     * @brief Returns the total number of children reaped.
+     *
+     * @return The count since construction.
+     */
+    std::uint64_t reaped() const;
+
+private:
+    /**
+     * @brief Table key for an unused slot.
+     */
+    static constexpr pid_t empty_pid = 0;
+
+    /**
+     * @brief Table key for a removed entry; keeps probe chains intact.
+     */
+    static constexpr pid_t tombstone_pid = -1;
+
+    /**
+     * @brief One hash table slot.
+     */
+    struct Slot
+    {
+        pid_t pid = empty_pid; ///< Key, or `empty_pid`/`tombstone_pid`.
+        ExitHandler handler;   ///< The child's handler.
+    };
+
+    /**
+     * @brief Finds the slot for `pid`.
+     *
+     * @note Called with `mutex` held.
+     *
+     * @param pid The key.
+     * @return The slot index, or -1 if absent.
+     */
+    long find(pid_t pid) const;
+
+    /**
+     * @brief Inserts a handler, growing the table if needed.
+     *
+     * @note Called with `mutex` held; `pid` must be absent.
+     *
+     * @param pid The key.
+     * @param handler The handler.
+     */
+    void insert(pid_t pid, ExitHandler handler);
+
+    /**
+     * @brief Rebuilds the table with room for `capacity` slots, dropping tombstones.
+     *
+     * @note Called with `mutex` held.
+     *
+     * @param capacity The new slot count, a power of two.
+     */
+    void rehash(std::size_t capacity);
+
+    /**
+     * @brief Takes the handler for an exit, or remembers the exit.
+     *
+     * @param exit The exit.
+     * @return The handler to call; empty if there is none.
+     */
+    ExitHandler claim(const Exit &exit);
+
+    /**
+     * @brief Converts `waitid()` output.
+     *
+     * @param info The result.
+     * @return The exit.
+     */
+    static Exit toExit(const siginfo_t &info);
+
+    /**
+     * @brief Protects the table, the default handler and `unmatched`.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Open-addressing table with linear probing; size is a power of two.
+     */
+    std::vector<Slot> slots;
+
+    /**
+     * @brief Live entries.
+     */
+    std::size_t live;
+
+    /**
+     * @brief Live entries plus tombstones; drives rehashing.
+     */
+    std::size_t used;
+
+    /**
+     * @brief Handler for unwatched exits.
+     */
+    ExitHandler default_handler;
+
+    /**
+     * @brief Unwatched exits, oldest first.
+     */
+    std::deque<Exit> unmatched;
+
+    /**
+     * @brief Children reaped so far.
+     */
+    std::uint64_t reaped_count;
+};
+
+#endif // SIGNAL_CHILD_HPP
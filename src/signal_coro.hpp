@@ -0,0 +1,194 @@
+/**
+ * @file signal_coro.hpp
+ * @brief C++20 coroutine awaitable for signals (`co_await handler.next(set)`).
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_CORO_HPP
+#define SIGNAL_CORO_HPP
+
+// Project libraries
+#include "signal_handler.hpp"
+
+#ifdef __cpp_impl_coroutine
+
+// Standard Libraries
+#include <coroutine>
+
+/**
+ * @brief Executor that resumes the coroutine on the dispatching thread.
+ *
+ * @details The default for `SignalHandler::next()`. With `startSignalFd()`
+ * the dispatching thread is whichever thread calls `dispatchPending()`,
+ * typically the event loop that owns the coroutine already.
+ */
+class SignalInlineExecutor
+{
+public:
+    /**
+     * @brief Resumes the coroutine immediately.
+     *
+     * @param handle The coroutine to resume.
+     */
+    void post(std::coroutine_handle<> handle)
+    {
+        handle.resume();
+    }
+};
+
+/**
+ * @brief Awaitable returned by `SignalHandler::next()`.
+ *
+ * @details
+ * The awaiter embeds its `SignalWaiter` node, so it lives in the awaiting
+ * coroutine's frame and nothing is allocated per `co_await`. On completion
+ * the coroutine is handed to `Executor::post()`, or resumed directly if no
+ * executor was given. `co_await` yields the `siginfo_t`, whose `si_signo`
+ * is 0 if the handler stopped (or was not running) first.
+ *
+ * The awaiting coroutine must not be destroyed while suspended here.
+ *
+ * @tparam Executor A type with `void post(std::coroutine_handle<>)`.
+ */
+template <typename Executor>
+class SignalAwaitable
+{
+public:
+    /**
+     * @brief Creates an awaitable; see `SignalHandler::next()`.
+     *
+     * @param h The handler to wait on.
+     * @param mask The signals to wait for (`signalBit()` layout).
+     * @param exec Where to resume, or nullptr to resume inline.
+     */
+    SignalAwaitable(SignalHandler &h, std::uint64_t mask, Executor *exec) noexcept
+        : handler(h), executor(exec)
+    {
+        node.mask = mask;
+        node.complete = &SignalAwaitable::onComplete;
+        node.context = this;
+    }
+
+    // The node's context pointer refers to this object
+    SignalAwaitable(const SignalAwaitable &) = delete;
+    SignalAwaitable &operator=(const SignalAwaitable &) = delete;
+
+    /**
+     * @brief Always suspends; signals are only reported after the await begins.
+     *
+     * @return false.
+     */
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Queues the waiter.
+     *
+     * @param h The awaiting coroutine.
+     * @return false (resume at once) if the handler is not running.
+     */
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        continuation = h;
+        return handler.addWaiter(node);
+    }
+
+    /**
+     * @brief Returns the signal that completed the wait.
+     *
+     * @return The signal information; `si_signo` is 0 if cancelled.
+     */
+    siginfo_t await_resume() const noexcept
+    {
+        return node.info;
+    }
+
+private:
+    /**
+     * @brief Completion called by the dispatching thread.
+     *
+     * @param w The embedded node.
+     */
+    static void onComplete(SignalWaiter *w)
+    {
+        auto *self = static_cast<SignalAwaitable *>(w->context);
+        std::coroutine_handle<> h = self->continuation;
+        if (self->executor != nullptr)
+        {
+            self->executor->post(h);
+        }
+        else
+        {
+            h.resume();
+        }
+    }
+
+    /**
+     * @brief The handler the waiter is queued on.
+     */
+    SignalHandler &handler;
+
+    /**
+     * @brief Where to resume, or nullptr for inline.
+     */
+    Executor *executor;
+
+    /**
+     * @brief The awaiting coroutine.
+     */
+    std::coroutine_handle<> continuation;
+
+    /**
+     * @brief Intrusive waiter node.
+     */
+    SignalWaiter node;
+};
+
+/**
+ * @brief Returns an awaitable for the next signal in `set`.
+ *
+ * @param set The signals to wait for.
+ * @param executor Where to resume, or nullptr for inline.
+ * @return The awaitable.
+ */
+template <typename Executor>
+SignalAwaitable<Executor> SignalHandler::next(const sigset_t &set, Executor *executor)
+{
+    std::uint64_t mask = 0;
+    for (int sig = 1; sig < signal_limit; ++sig)
+    {
+        if (sigismember(&set, sig) == 1)
+        {
+            mask |= signalBit(sig);
+        }
+    }
+    return SignalAwaitable<Executor>(*this, mask, executor);
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // SIGNAL_CORO_HPP
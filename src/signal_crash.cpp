@@ -0,0 +1,365 @@
+/**
+ * @file signal_crash.cpp
+ * @brief Async-signal-safe crash reporting for synchronous fault signals.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_crash.hpp"
+#include "signal_event_log.hpp"
+#include "signal_handler.hpp"
+
+// Standard libraries
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+// System Libraries
+#include <execinfo.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <cstdio> // For perror()
+#endif
+
+/**
+ * @brief Descriptor the crash record is written to.
+ */
+static std::atomic<int> crash_fd{STDERR_FILENO};
+
+/**
+ * @brief Set once `install()` has succeeded.
+ */
+static std::atomic<bool> crash_installed{false};
+
+/**
+ * @brief Shared-memory log crash records are appended to, if any.
+ */
+static std::atomic<SignalEventLog *> crash_log{nullptr};
+
+/**
+ * @brief TID of the first thread to enter the crash path, 0 if none.
+ */
+static std::atomic<long> crashing_tid{0};
+
+/**
+ * @brief Preallocated frame array for `backtrace()`.
+ */
+static void *crash_frames[SignalCrashHandler::max_frames];
+
+/**
+ * @brief Preallocated buffer the crash record header is formatted into.
+ */
+static char crash_record[256];
+
+/**
+ * @brief Appends a string to a fixed buffer without libc formatting.
+ *
+ * @param buf Destination buffer.
+ * @param pos Current length, advanced on return.
+ * @param cap Buffer capacity.
+ * @param str NUL-terminated string to append.
+ */
+static void appendString(char *buf, std::size_t &pos, std::size_t cap, const char *str)
+{
+    while (*str != '\0' && pos + 1 < cap)
+    {
+        buf[pos++] = *str++;
+    }
+}
+
+/**
+ * @brief Appends an unsigned integer in the given base (10 or 16).
+ *
+ * @param buf Destination buffer.
+ * @param pos Current length, advanced on return.
+ * @param cap Buffer capacity.
+ * @param value The value to format.
+ * @param base 10 or 16.
+ */
+static void appendNumber(char *buf, std::size_t &pos, std::size_t cap,
+                         unsigned long long value, unsigned base)
+{
+    static const char digits[] = "0123456789abcdef";
+    char tmp[24];
+    int n = 0;
+
+    do
+    {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while (value != 0 && n < static_cast<int>(sizeof(tmp)));
+
+    if (base == 16)
+    {
+        appendString(buf, pos, cap, "0x");
+    }
+
+    while (n > 0 && pos + 1 < cap)
+    {
+        buf[pos++] = tmp[--n];
+    }
+}
+
+/**
+ * @brief Writes a whole buffer, retrying short writes and EINTR.
+ *
+ * @param fd Destination descriptor.
+ * @param buf Data to write.
+ * @param len Number of bytes.
+ */
+static void writeAll(int fd, const char *buf, std::size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, buf, len);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            return;
+        }
+        buf += n;
+        len -= static_cast<std::size_t>(n);
+    }
+}
+
+/**
+ * @brief The `SA_SIGINFO` handler for fault signals.
+ *
+ * @details
+ * Runs on the alternate stack. Appends to the attached event log, then
+ * writes the record. Only async-signal-safe calls are made, all buffers are
+ * static, and a second thread crashing concurrently waits
+ * briefly so the first record is not cut short by process termination.
+ *
+ * @param sig The fault signal.
+ * @param info Fault details; `si_addr` is the faulting address.
+ * @param context Unused machine context.
+ */
+static void crashHandler(int sig, siginfo_t *info, void *context)
+{
+    (void)context;
+    int saved_errno = errno;
+    long tid = syscall(SYS_gettid);
+
+    long expected = 0;
+    if (crashing_tid.compare_exchange_strong(expected, tid))
+    {
+        // Memory stores only, so record it before anything that may fail
+        SignalEventLog *log = crash_log.load(std::memory_order_acquire);
+        if (log != nullptr)
+        {
+            log->append(SignalEventLog::Kind::Crash, *info, static_cast<int>(tid));
+        }
+
+        int fd = crash_fd.load(std::memory_order_relaxed);
+        std::size_t pos = 0;
+        const std::size_t cap = sizeof(crash_record);
+
+        appendString(crash_record, pos, cap, "*** Fatal signal ");
+        appendString(crash_record, pos, cap, SignalHandler::signalToString(sig).data());
+        appendString(crash_record, pos, cap, " (code ");
+        if (info->si_code < 0)
+        {
+            appendString(crash_record, pos, cap, "-"); // SI_USER, SI_TKILL, ...
+        }
+        appendNumber(crash_record, pos, cap,
+                     static_cast<unsigned>(info->si_code < 0 ? -info->si_code : info->si_code), 10);
+        appendString(crash_record, pos, cap, ")");
+        if (info->si_code > 0)
+        {
+            // Kernel-generated fault, si_addr is meaningful
+            appendString(crash_record, pos, cap, " addr ");
+            appendNumber(crash_record, pos, cap,
+                         reinterpret_cast<std::uintptr_t>(info->si_addr), 16);
+        }
+        appendString(crash_record, pos, cap, " pid ");
+        appendNumber(crash_record, pos, cap, static_cast<unsigned long long>(getpid()), 10);
+        appendString(crash_record, pos, cap, " tid ");
+        appendNumber(crash_record, pos, cap, static_cast<unsigned long long>(tid), 10);
+        appendString(crash_record, pos, cap, "\n");
+        writeAll(fd, crash_record, pos);
+
+        int frames = backtrace(crash_frames, SignalCrashHandler::max_frames);
+        backtrace_symbols_fd(crash_frames, frames, fd);
+
+        static const char trailer[] = "*** End of crash record\n";
+        writeAll(fd, trailer, sizeof(trailer) - 1);
+    }
+    else if (expected != tid)
+    {
+        // Another thread is reporting; give it a moment to finish
+        const timespec pause = {0, 100 * 1000 * 1000};
+        for (int i = 0; i < 10; ++i)
+        {
+            nanosleep(&pause, nullptr);
+        }
+    }
+
+    // Restore the default action and re-raise for the usual exit status/core
+    struct sigaction dfl;
+    std::memset(&dfl, 0, sizeof(dfl));
+    dfl.sa_handler = SIG_DFL;
+    sigemptyset(&dfl.sa_mask);
+    sigaction(sig, &dfl, nullptr);
+
+    errno = saved_errno;
+    syscall(SYS_tgkill, getpid(), tid, sig);
+}
+
+/**
+ * @brief Installs the crash handlers for every signal in `fault_mask`.
+ *
+ * @details
+ * - Records the output descriptor.
+ * - Calls `backtrace()` once so libgcc is loaded before any crash, since the
+ *   first call may allocate.
+ * - Gives the calling thread an alternate stack, so stack overflows can
+ *   still be reported.
+ * - Installs `SA_SIGINFO | SA_ONSTACK` handlers.
+ * - Unblocks the fault signals in the calling thread.
+ *
+ * @param fd Descriptor the crash record is written to.
+ * @return `true` if all handlers were installed.
+ */
+bool SignalCrashHandler::install(int fd)
+{
+    crash_fd.store(fd, std::memory_order_relaxed);
+
+    // Warm up backtrace() outside of signal context
+    void *warmup[2];
+    backtrace(warmup, 2);
+
+    armThread();
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = crashHandler;
+    sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&sa.sa_mask);
+
+    sigset_t faults;
+    sigemptyset(&faults);
+
+    bool ok = true;
+    for (int sig = 1; sig < SignalHandler::signal_limit; ++sig)
+    {
+        if ((fault_mask & SignalHandler::signalBit(sig)) == 0)
+            continue;
+
+        sigaddset(&faults, sig);
+        if (sigaction(sig, &sa, nullptr) != 0)
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("sigaction");
+#endif
+            ok = false;
+        }
+    }
+
+    // A blocked fault signal bypasses the handler, so never block them
+    pthread_sigmask(SIG_UNBLOCK, &faults, nullptr);
+
+    crash_installed.store(ok, std::memory_order_release);
+    return ok;
+}
+
+/**
+ * @brief Gives the calling thread an alternate signal stack.
+ *
+ * @details
+ * The stack is mapped once per thread and intentionally never unmapped, so
+ * it stays valid for the thread's whole lifetime. Threads that already have
+ * an alternate stack keep it.
+ *
+ * @return `true` if the thread has an alternate stack.
+ */
+bool SignalCrashHandler::armThread()
+{
+    stack_t current;
+    if (sigaltstack(nullptr, &current) == 0 && !(current.ss_flags & SS_DISABLE))
+    {
+        return true;
+    }
+
+    void *mem = mmap(nullptr, alt_stack_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("mmap");
+#endif
+        return false;
+    }
+
+    stack_t ss;
+    ss.ss_sp = mem;
+    ss.ss_size = alt_stack_size;
+    ss.ss_flags = 0;
+    if (sigaltstack(&ss, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("sigaltstack");
+#endif
+        munmap(mem, alt_stack_size);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Attaches the shared-memory log for crash records.
+ *
+ * @param log The log, or nullptr to detach.
+ */
+void SignalCrashHandler::setEventLog(SignalEventLog *log)
+{
+    crash_log.store(log, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the attached crash log.
+ *
+ * @return The log, or nullptr.
+ */
+SignalEventLog *SignalCrashHandler::eventLog()
+{
+    return crash_log.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Reports whether the crash path is installed.
+ *
+ * @return `true` after a successful `install()`.
+ */
+bool SignalCrashHandler::installed()
+{
+    return crash_installed.load(std::memory_order_acquire);
+}
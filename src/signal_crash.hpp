@@ -0,0 +1,127 @@
+/**
+ * @file signal_crash.hpp
+ * @brief Async-signal-safe crash reporting for synchronous fault signals.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_CRASH_HPP
+#define SIGNAL_CRASH_HPP
+
+// Standard Libraries
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+
+// System libraries
+#include <unistd.h>
+
+class SignalEventLog;
+
+/**
+ * @brief Installs a real `sigaction` crash path for fault signals.
+ *
+ * @details
+ * SIGSEGV, SIGBUS, SIGFPE and SIGILL raised by a fault are delivered to the
+ * faulting thread, and the kernel forces the default action if they are
+ * blocked there, so the signal thread can never see them. SIGABRT from
+ * `abort()` behaves the same way. Once installed, these signals get a
+ * `SA_ONSTACK` handler instead:
+ * - A crash record (signal, code, fault address, PID, TID) is formatted
+ *   into a preallocated buffer and written with a single `write()`.
+ * - A backtrace is captured into a preallocated frame array and written
+ *   with `backtrace_symbols_fd()`, which does not allocate.
+ * - The default action is restored and the signal re-raised, so exit
+ *   status and core dumps are unchanged.
+ *
+ * If an event log has been attached with `setEventLog()`, a crash record is
+ * appended to it first, so it survives even if the descriptor write fails.
+ *
+ * The handler uses no locks and no allocation. Once installed, the fault
+ * signals are no longer blocked or waited on by SignalHandler.
+ */
+class SignalCrashHandler
+{
+public:
+    /**
+     * @brief Signals routed to the crash path (`SignalHandler::signalBit()` layout).
+     */
+    static constexpr std::uint64_t fault_mask =
+        (std::uint64_t{1} << (SIGSEGV - 1)) | (std::uint64_t{1} << (SIGBUS - 1)) |
+        (std::uint64_t{1} << (SIGFPE - 1)) | (std::uint64_t{1} << (SIGILL - 1)) |
+        (std::uint64_t{1} << (SIGABRT - 1));
+
+    /**
+     * @brief Maximum number of frames captured per crash.
+     */
+    static constexpr int max_frames = 64;
+
+    /**
+     * @brief Size of each alternate signal stack.
+     */
+    static constexpr std::size_t alt_stack_size = 64 * 1024;
+
+    /**
+     * @brief Installs the crash handlers and an alternate stack for the caller.
+     *
+     * @details Call early, before spawning threads: the fault signals are
+     * unblocked in the calling thread so threads created afterwards inherit
+     * an unblocked mask. Other threads should call `armThread()` so a stack
+     * overflow there can still be reported.
+     *
+     * @param fd Descriptor the crash record is written to.
+     * @return true if every handler was installed.
+     */
+    static bool install(int fd = STDERR_FILENO);
+
+    /**
+     * @brief Gives the calling thread its own alternate signal stack.
+     *
+     * @return true if the thread has an alternate stack.
+     */
+    static bool armThread();
+
+    /**
+     * @brief Sets the shared-memory log crash records are appended to.
+     *
+     * @param log The log, or nullptr to detach. Must stay mapped while set.
+     */
+    static void setEventLog(SignalEventLog *log);
+
+    /**
+     * @brief Returns the log set with `setEventLog()`.
+     *
+     * @return The attached log, or nullptr.
+     */
+    static SignalEventLog *eventLog();
+
+    /**
+     * @brief Reports whether `install()` has succeeded.
+     *
+     * @return true if the crash path owns the fault signals.
+     */
+    static bool installed();
+};
+
+#endif // SIGNAL_CRASH_HPP
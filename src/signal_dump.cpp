@@ -0,0 +1,359 @@
+/**
+ * @file signal_dump.cpp
+ * @brief JVM-style state dump: every thread's stack, dispatch stats and user state.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_dump.hpp"
+#include "signal_backtrace.hpp"
+
+// Standard libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+// System libraries
+#include <dirent.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/**
+ * @brief Reads a small `/proc` file into `buf`.
+ *
+ * @param path The file.
+ * @param buf Output buffer.
+ * @param size Its size.
+ * @return The number of bytes read, 0 on error.
+ */
+static std::size_t readProcFile(const char *path, char *buf, std::size_t size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0)
+    {
+        return 0;
+    }
+    buf[n] = '\0';
+    return static_cast<std::size_t>(n);
+}
+
+/**
+ * @brief Appends a formatted value.
+ *
+ * @param out The text.
+ * @param format A printf format.
+ */
+template <typename... Args>
+static void appendf(std::string &out, const char *format, Args... args)
+{
+    char buf[256];
+    int n = std::snprintf(buf, sizeof(buf), format, args...);
+    if (n > 0)
+    {
+        out.append(buf, static_cast<std::size_t>(n) < sizeof(buf) ? static_cast<std::size_t>(n) : sizeof(buf) - 1);
+    }
+}
+
+/**
+ * @brief Adds a section.
+ *
+ * @param name Section title.
+ * @param provider Appends the section's text.
+ * @return `true` if added.
+ */
+bool SignalStateDump::addProvider(std::string name, const Provider &provider)
+{
+    if (!provider)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    providers.emplace_back(std::move(name), provider);
+    return true;
+}
+
+/**
+ * @brief Builds the dump and writes it with one `writev()`.
+ *
+ * @details Each section is its own buffer and its own iovec entry. A
+ * partial write (a pipe, or a signal) resumes from where it stopped; only
+ * more than `IOV_MAX` sections need further calls.
+ *
+ * @param fd The output descriptor.
+ * @param stats The counters.
+ * @return Bytes written, or -1.
+ */
+long SignalStateDump::write(int fd, const SignalStats &stats)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::string> sections;
+    sections.reserve(providers.size() + 3);
+
+    std::string header;
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    tm utc;
+    gmtime_r(&now.tv_sec, &utc);
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", &utc);
+    appendf(header, "=== State dump: pid %d at %s.%03ldZ ===\n",
+            static_cast<int>(getpid()), when, now.tv_nsec / 1000000);
+    sections.push_back(std::move(header));
+
+    std::string threads;
+    appendThreads(threads);
+    sections.push_back(std::move(threads));
+
+    std::string counters;
+    appendStats(counters, stats);
+    sections.push_back(std::move(counters));
+
+    for (auto &entry : providers)
+    {
+        std::string text = "\n--- " + entry.first + " ---\n";
+        entry.second(text);
+        if (text.back() != '\n')
+        {
+            text += '\n';
+        }
+        sections.push_back(std::move(text));
+    }
+    sections.back() += "=== End of state dump ===\n\n";
+
+    std::vector<iovec> iov(sections.size());
+    for (std::size_t i = 0; i < sections.size(); ++i)
+    {
+        iov[i].iov_base = &sections[i][0];
+        iov[i].iov_len = sections[i].size();
+    }
+
+    long total = 0;
+    std::size_t first = 0;
+    while (first < iov.size())
+    {
+        int count = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+        ssize_t n = writev(fd, &iov[first], count);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("writev");
+#endif
+            return -1;
+        }
+
+        total += n;
+        std::size_t left = static_cast<std::size_t>(n);
+        while (first < iov.size() && left >= iov[first].iov_len)
+        {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (first < iov.size())
+        {
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+
+    dump_count.fetch_add(1, std::memory_order_relaxed);
+    return total;
+}
+
+/**
+ * @brief Appends a dump to `path`.
+ *
+ * @param path Output file; empty for stderr.
+ * @param stats The counters.
+ * @return `true` if the whole dump was written.
+ */
+bool SignalStateDump::writeTo(const std::string &path, const SignalStats &stats)
+{
+    int fd = STDERR_FILENO;
+    if (!path.empty())
+    {
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("open");
+#endif
+            return false;
+        }
+    }
+
+    bool ok = write(fd, stats) >= 0;
+
+    if (fd != STDERR_FILENO)
+    {
+        close(fd);
+    }
+    return ok;
+}
+
+/**
+ * @brief Returns the dump count.
+ *
+ * @return Dumps written.
+ */
+std::uint64_t SignalStateDump::dumps() const noexcept
+{
+    return dump_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Lists every thread with its state and stack.
+ *
+ * @details The name comes from `/proc/self/task/<tid>/comm` and the state
+ * letter (R, S, D, ...) from the field after the name in `stat`. Threads
+ * that exit during the walk or do not answer are listed without frames.
+ *
+ * @param out The dump text.
+ */
+void SignalStateDump::appendThreads(std::string &out)
+{
+    DIR *dir = opendir("/proc/self/task");
+    if (dir == nullptr)
+    {
+        out += "\n(thread list unavailable)\n";
+        return;
+    }
+
+    std::vector<pid_t> tids;
+    while (dirent *entry = readdir(dir))
+    {
+        int tid = std::atoi(entry->d_name);
+        if (tid > 0)
+        {
+            tids.push_back(static_cast<pid_t>(tid));
+        }
+    }
+    closedir(dir);
+
+    pid_t self = static_cast<pid_t>(syscall(SYS_gettid));
+    for (pid_t tid : tids)
+    {
+        char path[64];
+        char buf[512];
+
+        std::snprintf(path, sizeof(path), "/proc/self/task/%d/comm", static_cast<int>(tid));
+        std::string name = readProcFile(path, buf, sizeof(buf)) ? buf : "?";
+        if (!name.empty() && name.back() == '\n')
+        {
+            name.pop_back();
+        }
+
+        char state = '?';
+        std::snprintf(path, sizeof(path), "/proc/self/task/%d/stat", static_cast<int>(tid));
+        if (readProcFile(path, buf, sizeof(buf)))
+        {
+            // The name may contain spaces and parentheses; the state follows the last ')'
+            const char *close_paren = std::strrchr(buf, ')');
+            if (close_paren != nullptr && close_paren[1] == ' ')
+            {
+                state = close_paren[2];
+            }
+        }
+
+        appendf(out, "\n\"%s\" tid=%d state=%c%s\n", name.c_str(), static_cast<int>(tid),
+                state, tid == self ? " (dumping)" : "");
+
+        void *frames[SignalBacktrace::max_frames];
+        int depth = SignalBacktrace::capture(tid, frames, SignalBacktrace::max_frames, capture_timeout);
+        if (depth <= 0)
+        {
+            out += "    (no stack: signal blocked or thread not responding)\n";
+            continue;
+        }
+
+        char **symbols = backtrace_symbols(frames, depth);
+        for (int i = 0; i < depth; ++i)
+        {
+            if (symbols != nullptr)
+            {
+                appendf(out, "    at %s\n", symbols[i]);
+            }
+            else
+            {
+                appendf(out, "    at %p\n", frames[i]);
+            }
+        }
+        std::free(symbols);
+    }
+}
+
+/**
+ * @brief Lists the dispatch counters and per-signal latencies.
+ *
+ * @param out The dump text.
+ * @param stats The counters.
+ */
+void SignalStateDump::appendStats(std::string &out, const SignalStats &stats)
+{
+    appendf(out, "\n--- Signal dispatch ---\n"
+                 "wakeups=%llu received=%llu dispatched=%llu dropped=%llu batched=%llu"
+                 " suppressed=%llu\n",
+            static_cast<unsigned long long>(stats.wakeups),
+            static_cast<unsigned long long>(stats.received),
+            static_cast<unsigned long long>(stats.dispatched),
+            static_cast<unsigned long long>(stats.dropped),
+            static_cast<unsigned long long>(stats.batched),
+            static_cast<unsigned long long>(stats.suppressed));
+
+    for (const SignalStats::PerSignal &entry : stats.signals)
+    {
+        appendf(out, "signal %-3d received=%llu suppressed=%llu latency p50=%lluns p99=%lluns max=%lluns"
+                     " handler p99=%lluns\n",
+                entry.signo,
+                static_cast<unsigned long long>(entry.received),
+                static_cast<unsigned long long>(entry.suppressed),
+                static_cast<unsigned long long>(entry.latency.percentile(0.50)),
+                static_cast<unsigned long long>(entry.latency.percentile(0.99)),
+                static_cast<unsigned long long>(entry.latency.max_ns),
+                static_cast<unsigned long long>(entry.duration.percentile(0.99)));
+    }
+}
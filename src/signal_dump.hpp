@@ -0,0 +1,152 @@
+/**
+ * @file signal_dump.hpp
+ * @brief JVM-style state dump: every thread's stack, dispatch stats and user state.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_DUMP_HPP
+#define SIGNAL_DUMP_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project libraries
+#include "signal_function.hpp"
+#include "signal_stats.hpp"
+
+/**
+ * @brief Writes a snapshot of the live process.
+ *
+ * @details
+ * A dump has four sections:
+ * - a header with the process ID and the wall-clock time;
+ * - every thread in `/proc/self/task`, with its name, scheduler state and
+ *   stack, captured with `SignalBacktrace`;
+ * - the dispatch counters and per-signal latency percentiles;
+ * - the text of every registered provider, in registration order.
+ *
+ * The text is assembled in memory and written with one `writev()`, so
+ * dumps appended to the same file by several processes do not interleave
+ * and a reader never sees half a section.
+ *
+ * Symbols come from `backtrace_symbols()`, which needs `-rdynamic` to name
+ * functions in the executable; without it frames show as module+offset.
+ */
+class SignalStateDump
+{
+public:
+    /**
+     * @brief Appends one section of application state to `out`.
+     */
+    using Provider = SignalInplaceFunction<void(std::string &out)>;
+
+    /**
+     * @brief How long each thread has to answer its stack capture.
+     */
+    static constexpr std::chrono::milliseconds capture_timeout{50};
+
+    SignalStateDump() = default;
+
+    // Providers may capture pointers to their owner
+    SignalStateDump(const SignalStateDump &) = delete;
+    SignalStateDump &operator=(const SignalStateDump &) = delete;
+
+    /**
+     * @brief Adds a named section to every later dump.
+     *
+     * @details Providers run on the dumping thread, which for
+     * `SignalHandler::enableStateDump()` is the dispatching thread; they
+     * should read state without blocking on locks other threads may hold.
+     *
+     * @param name Section title.
+     * @param provider Appends the section's text.
+     * @return false if `provider` is empty.
+     */
+    bool addProvider(std::string name, const Provider &provider);
+
+    /**
+     * @brief Writes a dump to a descriptor.
+     *
+     * @param fd The output descriptor.
+     * @param stats Dispatch counters to include.
+     * @return The number of bytes written, or -1 on a write error.
+     */
+    long write(int fd, const SignalStats &stats);
+
+    /**
+     * @brief Appends a dump to a file.
+     *
+     * @param path Output file, created if missing; empty for stderr.
+     * @param stats Dispatch counters to include.
+     * @return false if the file could not be opened or written.
+     */
+    bool writeTo(const std::string &path, const SignalStats &stats);
+
+    /**
+     * @brief Returns the number of dumps written.
+     *
+     * @return The dump count.
+     */
+    std::uint64_t dumps() const noexcept;
+
+private:
+    /**
+     * @brief Appends the thread section.
+     *
+     * @param out The dump text.
+     */
+    static void appendThreads(std::string &out);
+
+    /**
+     * @brief Appends the stats section.
+     *
+     * @param out The dump text.
+     * @param stats The counters.
+     */
+    static void appendStats(std::string &out, const SignalStats &stats);
+
+    /**
+     * @brief Protects `providers`; held for the whole dump.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Registered sections.
+     */
+    std::vector<std::pair<std::string, Provider>> providers;
+
+    /**
+     * @brief Dumps written so far.
+     */
+    std::atomic<std::uint64_t> dump_count{0};
+};
+
+#endif // SIGNAL_DUMP_HPP
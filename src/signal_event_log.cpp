@@ -0,0 +1,329 @@
+/**
+ * @file signal_event_log.cpp
+ * @brief A shared-memory ring of signal events that outlives the process.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_event_log.hpp"
+
+// Standard libraries
+#include <cstring>
+#include <new>
+
+// System Libraries
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <cstdio> // For perror()
+#endif
+
+/**
+ * @brief Offset of the first record; the header gets its own cache lines.
+ */
+static constexpr std::size_t records_offset = 128;
+
+static_assert(sizeof(SignalEventLog::Header) <= records_offset, "header overlaps records");
+
+/**
+ * @brief Destructor; unmaps the log but leaves the file in place.
+ */
+SignalEventLog::~SignalEventLog()
+{
+    close();
+}
+
+/**
+ * @brief Creates and maps a new, empty log.
+ *
+ * @details
+ * With a path, the file is created (or truncated) with mode 0600 and sized
+ * with `ftruncate()`. With nullptr, an anonymous memfd is used instead; its
+ * descriptor is available through `fd()` for handing to a supervisor
+ * before anything goes wrong.
+ *
+ * @param path File to create, or nullptr for a memfd.
+ * @param capacity Requested number of records, rounded up to a power of two.
+ * @return `true` if the log is ready for `append()`.
+ */
+bool SignalEventLog::create(const char *path, std::size_t capacity)
+{
+    close();
+
+    std::size_t cap = 1;
+    while (cap < capacity)
+    {
+        cap <<= 1;
+    }
+
+    log_fd = (path != nullptr) ? ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)
+                               : memfd_create("signal_event_log", MFD_CLOEXEC);
+    if (log_fd < 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("open(event log)");
+#endif
+        return false;
+    }
+
+    map_size = records_offset + cap * sizeof(Record);
+    if (ftruncate(log_fd, static_cast<off_t>(map_size)) != 0 || !map(true))
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("ftruncate(event log)");
+#endif
+        close();
+        return false;
+    }
+
+    // The file is zero-filled, so only the header needs writing
+    header->magic = log_magic;
+    header->version = log_version;
+    header->record_size = sizeof(Record);
+    header->capacity = cap;
+    header->owner_pid = static_cast<std::int32_t>(getpid());
+    new (&header->head) std::atomic<std::uint64_t>(0);
+    mask = cap - 1;
+
+    return true;
+}
+
+/**
+ * @brief Maps an existing log from a descriptor.
+ *
+ * @details
+ * Validates the magic, version and record size before accepting the
+ * mapping, so a supervisor can safely point it at an arbitrary file.
+ *
+ * @param fd Descriptor of the log; duplicated internally.
+ * @param writable `true` to allow `append()`.
+ * @return `true` if the descriptor holds a compatible log.
+ */
+bool SignalEventLog::attach(int fd, bool writable)
+{
+    close();
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < records_offset)
+    {
+        return false;
+    }
+
+    log_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (log_fd < 0)
+    {
+        return false;
+    }
+
+    map_size = static_cast<std::size_t>(st.st_size);
+    if (!map(writable))
+    {
+        close();
+        return false;
+    }
+
+    std::uint64_t cap = header->capacity;
+    if (header->magic != log_magic || header->version != log_version ||
+        header->record_size != sizeof(Record) || cap == 0 || (cap & (cap - 1)) != 0 ||
+        records_offset + cap * sizeof(Record) > map_size)
+    {
+        close();
+        return false;
+    }
+
+    mask = cap - 1;
+    return true;
+}
+
+/**
+ * @brief Maps the descriptor and sets the header and record pointers.
+ *
+ * @param writable Map with write access if true.
+ * @return `true` on success.
+ */
+bool SignalEventLog::map(bool writable)
+{
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *addr = mmap(nullptr, map_size, prot, MAP_SHARED, log_fd, 0);
+    if (addr == MAP_FAILED)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("mmap(event log)");
+#endif
+        return false;
+    }
+
+    mapping = addr;
+    header = static_cast<Header *>(addr);
+    records = reinterpret_cast<Record *>(static_cast<char *>(addr) + records_offset);
+    return true;
+}
+
+/**
+ * @brief Unmaps the log and closes the descriptor.
+ */
+void SignalEventLog::close()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, map_size);
+    }
+    if (log_fd >= 0)
+    {
+        ::close(log_fd);
+    }
+
+    log_fd = -1;
+    mapping = nullptr;
+    map_size = 0;
+    header = nullptr;
+    records = nullptr;
+    mask = 0;
+}
+
+/**
+ * @brief Reports whether a log is mapped.
+ *
+ * @return `true` if mapped.
+ */
+bool SignalEventLog::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Returns the backing descriptor.
+ *
+ * @return The descriptor, or -1 if closed.
+ */
+int SignalEventLog::fd() const
+{
+    return log_fd;
+}
+
+/**
+ * @brief Appends a record to the ring.
+ *
+ * @details
+ * Claims the next index with a relaxed `fetch_add` on the shared head, so
+ * concurrent writers (the signal thread and a crashing thread) never wait
+ * on each other. The record's sequence is odd while its fields are being
+ * stored and is set to `2 * index + 2` with release ordering once done.
+ *
+ * @param kind What produced the record.
+ * @param info The signal information to record.
+ * @param tid The receiving thread ID, or 0.
+ */
+void SignalEventLog::append(Kind kind, const siginfo_t &info, int tid) noexcept
+{
+    if (header == nullptr)
+    {
+        return;
+    }
+
+    std::uint64_t index = header->head.fetch_add(1, std::memory_order_relaxed);
+    Record &rec = records[index & mask];
+    auto *seq = reinterpret_cast<std::atomic<std::uint64_t> *>(&rec.seq);
+
+    seq->store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    rec.timestamp_ns = static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    rec.kind = static_cast<std::uint32_t>(kind);
+    rec.signo = info.si_signo;
+    rec.code = info.si_code;
+    rec.pid = static_cast<std::int32_t>(info.si_pid);
+    rec.uid = static_cast<std::uint32_t>(info.si_uid);
+    rec.tid = tid;
+    rec.value = reinterpret_cast<std::uintptr_t>(info.si_value.sival_ptr);
+    rec.addr = (kind == Kind::Crash) ? reinterpret_cast<std::uintptr_t>(info.si_addr) : 0;
+
+    seq->store(2 * index + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Copies the most recent complete records, oldest first.
+ *
+ * @details
+ * Records that are mid-write, or were overwritten while being copied, are
+ * skipped, so the result never contains torn data.
+ *
+ * @param out Destination array.
+ * @param max Capacity of `out`.
+ * @return The number of records copied.
+ */
+std::size_t SignalEventLog::snapshot(Record *out, std::size_t max) const
+{
+    if (header == nullptr || max == 0)
+    {
+        return 0;
+    }
+
+    std::uint64_t head = header->head.load(std::memory_order_acquire);
+    std::uint64_t span = mask + 1;
+    std::uint64_t first = (head > span) ? head - span : 0;
+    if (head - first > max)
+    {
+        first = head - max;
+    }
+
+    std::size_t copied = 0;
+    for (std::uint64_t index = first; index < head; ++index)
+    {
+        const Record &rec = records[index & mask];
+        const auto *seq = reinterpret_cast<const std::atomic<std::uint64_t> *>(&rec.seq);
+
+        std::uint64_t before = seq->load(std::memory_order_acquire);
+        if (before != 2 * index + 2)
+            continue;
+
+        std::memcpy(&out[copied], &rec, sizeof(Record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq->load(std::memory_order_relaxed) != before)
+            continue;
+
+        ++copied;
+    }
+
+    return copied;
+}
+
+/**
+ * @brief Flushes the mapping to its backing store.
+ */
+void SignalEventLog::sync() const noexcept
+{
+    if (mapping != nullptr)
+    {
+        msync(mapping, map_size, MS_SYNC);
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ * @file signal_event_log.hpp
+ * @brief A shared-memory ring of signal events that outlives the process.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_EVENT_LOG_HPP
+#define SIGNAL_EVENT_LOG_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-size binary log of signal events in a shared mapping.
+ *
+ * @details
+ * The log is a header followed by a power-of-two ring of 64-byte records,
+ * mapped `MAP_SHARED` from a file (typically in `/dev/shm`) or a memfd. A
+ * supervisor can map the same file after the process dies and read the last
+ * `capacity` events with `snapshot()`.
+ *
+ * `append()` claims a slot with one `fetch_add` and publishes it through a
+ * per-record sequence number. It performs no allocation, takes no lock and
+ * makes no system call (the timestamp comes from the vDSO), so it is safe
+ * from the crash path and from several threads at once.
+ */
+class SignalEventLog
+{
+public:
+    /**
+     * @brief What produced a record.
+     */
+    enum class Kind : std::uint32_t
+    {
+        Signal = 1, ///< Signal dispatched by SignalHandler.
+        Crash = 2,  ///< Fault signal caught by SignalCrashHandler.
+        Escalation = 3 ///< Forced exit when the termination grace budget ran out.
+    };
+
+    /**
+     * @brief One log record; the layout is part of the file format.
+     */
+    struct Record
+    {
+        std::uint64_t seq;          ///< 2 * index + 2 once complete, odd while written.
+        std::int64_t timestamp_ns;  ///< CLOCK_REALTIME at append.
+        std::uint32_t kind;         ///< A `Kind` value.
+        std::int32_t signo;         ///< Signal number.
+        std::int32_t code;          ///< `si_code`.
+        std::int32_t pid;           ///< Sender PID (`si_pid`).
+        std::uint32_t uid;          ///< Sender UID (`si_uid`).
+        std::int32_t tid;           ///< Receiving thread, if known.
+        std::uint64_t value;        ///< `si_value`.
+        std::uint64_t addr;         ///< Fault address for crash records.
+        std::uint64_t reserved;     ///< Padding to 64 bytes.
+    };
+
+    /**
+     * @brief File header; the layout is part of the file format.
+     */
+    struct Header
+    {
+        std::uint64_t magic;        ///< `log_magic`.
+        std::uint32_t version;      ///< `log_version`.
+        std::uint32_t record_size;  ///< sizeof(Record).
+        std::uint64_t capacity;     ///< Number of records, a power of two.
+        std::int32_t owner_pid;     ///< PID of the writer.
+        std::uint32_t reserved;     ///< Padding.
+        alignas(64) std::atomic<std::uint64_t> head; ///< Records ever appended.
+    };
+
+    static_assert(sizeof(Record) == 64, "Record is part of the on-disk format");
+
+    /**
+     * @brief Identifies a mapped event log ("SIGEVLOG").
+     */
+    static constexpr std::uint64_t log_magic = 0x474f4c5645474953ULL;
+
+    /**
+     * @brief Current layout version.
+     */
+    static constexpr std::uint32_t log_version = 1;
+
+    SignalEventLog() = default;
+    ~SignalEventLog();
+
+    // The mapping is owned exclusively
+    SignalEventLog(const SignalEventLog &) = delete;
+    SignalEventLog &operator=(const SignalEventLog &) = delete;
+
+    /**
+     * @brief Creates a new, empty log.
+     *
+     * @param path File to create or truncate (e.g. "/dev/shm/myapp.sig"),
+     *             or nullptr for an anonymous memfd (see `fd()`).
+     * @param capacity Number of records, rounded up to a power of two.
+     * @return true if the log is mapped and ready.
+     */
+    bool create(const char *path, std::size_t capacity);
+
+    /**
+     * @brief Maps an existing log, e.g. an inherited memfd or a dead process's file.
+     *
+     * @param fd Descriptor of the log; duplicated, so the caller keeps ownership.
+     * @param writable true to append to the log, false for a read-only view.
+     * @return true if the descriptor holds a valid log.
+     */
+    bool attach(int fd, bool writable);
+
+    /**
+     * @brief Unmaps the log and closes its descriptor. The file is kept.
+     */
+    void close();
+
+    /**
+     * @brief Reports whether a log is mapped.
+     *
+     * @return true between a successful `create()`/`attach()` and `close()`.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the log's descriptor, e.g. to pass a memfd to a supervisor.
+     *
+     * @return The descriptor, or -1 if closed.
+     */
+    int fd() const;
+
+    /**
+     * @brief Appends a record. Async-signal-safe and wait-free.
+     *
+     * @param kind What produced the record.
+     * @param info The signal information to record.
+     * @param tid The receiving thread ID, or 0 if unknown.
+     */
+    void append(Kind kind, const siginfo_t &info, int tid = 0) noexcept;
+
+    /**
+     * @brief Copies the most recent complete records, oldest first.
+     *
+     * @param out Destination array.
+     * @param max Capacity of `out`.
+     * @return The number of records copied.
+     */
+    std::size_t snapshot(Record *out, std::size_t max) const;
+
+    /**
+     * @brief Flushes a file-backed log to its backing store.
+     *
+     * @details Not needed for a supervisor on the same host, which shares
+     * the page cache, but useful before a forced exit on persistent storage.
+     */
+    void sync() const noexcept;
+
+private:
+    /**
+     * @brief Maps `map_size` bytes of `log_fd`.
+     *
+     * @param writable Map read-write if true.
+     * @return true on success.
+     */
+    bool map(bool writable);
+
+    /**
+     * @brief Descriptor of the backing file or memfd, -1 if closed.
+     */
+    int log_fd = -1;
+
+    /**
+     * @brief Base of the shared mapping.
+     */
+    void *mapping = nullptr;
+
+    /**
+     * @brief Size of the shared mapping in bytes.
+     */
+    std::size_t map_size = 0;
+
+    /**
+     * @brief Header at the start of the mapping.
+     */
+    Header *header = nullptr;
+
+    /**
+     * @brief Record ring following the header.
+     */
+    Record *records = nullptr;
+
+    /**
+     * @brief `capacity - 1`, for indexing the ring.
+     */
+    std::uint64_t mask = 0;
+};
+
+#endif // SIGNAL_EVENT_LOG_HPP
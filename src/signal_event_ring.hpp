@@ -0,0 +1,228 @@
+/**
+ * @file signal_event_ring.hpp
+ * @brief A lock-free ring that broadcasts received signals to polling threads.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_EVENT_RING_HPP
+#define SIGNAL_EVENT_RING_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+
+// System libraries
+#include <sys/types.h>
+
+/**
+ * @brief A received signal and the siginfo_t fields workers usually need.
+ */
+struct SignalEvent
+{
+    int signo;    ///< Signal number.
+    int code;     ///< `si_code` (e.g. SI_USER, SI_QUEUE).
+    pid_t pid;    ///< Sending process, if any.
+    uid_t uid;    ///< Real user ID of the sender, if any.
+    sigval value; ///< Payload attached by `sigqueue()`, if any.
+};
+
+/**
+ * @brief Single-producer, multi-consumer broadcast ring of signal events.
+ *
+ * @details
+ * The signal thread is the only producer. Any number of consumers each keep
+ * their own `Cursor` and see every event published after they subscribed,
+ * so there is no shared read index and no lock. The hot-path check,
+ * `pending()`, is a single relaxed load of the head counter.
+ *
+ * Slots are protected by a per-slot sequence number (a seqlock), so a
+ * consumer that falls more than `capacity` events behind skips ahead and
+ * records how many events it lost instead of reading torn data.
+ */
+class SignalEventRing
+{
+public:
+    /**
+     * @brief Number of slots; must be a power of two.
+     */
+    static constexpr std::size_t capacity = 256;
+
+    /**
+     * @brief Per-consumer read position.
+     */
+    struct Cursor
+    {
+        std::uint64_t next = 0; ///< Sequence of the next event to read.
+        std::uint64_t lost = 0; ///< Events overwritten before they were read.
+    };
+
+    SignalEventRing() = default;
+
+    // The ring is shared by address; copying it would detach consumers
+    SignalEventRing(const SignalEventRing &) = delete;
+    SignalEventRing &operator=(const SignalEventRing &) = delete;
+
+    /**
+     * @brief Creates a cursor positioned at the next event to be published.
+     *
+     * @return A cursor that will see only future events.
+     */
+    Cursor subscribe() const noexcept
+    {
+        Cursor cursor;
+        cursor.next = head.load(std::memory_order_acquire);
+        return cursor;
+    }
+
+    /**
+     * @brief Cheap hot-path test for unread events.
+     *
+     * @param cursor The consumer's cursor.
+     * @return true if at least one event was published since the cursor.
+     */
+    bool pending(const Cursor &cursor) const noexcept
+    {
+        return head.load(std::memory_order_relaxed) != cursor.next;
+    }
+
+    /**
+     * @brief Total number of events published so far.
+     *
+     * @return The producer's head sequence.
+     */
+    std::uint64_t published() const noexcept
+    {
+        return head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publishes a signal to every consumer.
+     *
+     * @param info The signal information to publish.
+     *
+     * @warning Only one thread may publish; this is the signal thread.
+     */
+    void publish(const siginfo_t &info) noexcept
+    {
+        std::uint64_t pos = head.load(std::memory_order_relaxed);
+        Slot &slot = slots[pos & (capacity - 1)];
+
+        // Odd sequence marks the slot as being written
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.signo.store(info.si_signo, std::memory_order_relaxed);
+        slot.code.store(info.si_code, std::memory_order_relaxed);
+        slot.pid.store(info.si_pid, std::memory_order_relaxed);
+        slot.uid.store(info.si_uid, std::memory_order_relaxed);
+        slot.value.store(reinterpret_cast<std::uintptr_t>(info.si_value.sival_ptr),
+                         std::memory_order_relaxed);
+
+        // Even sequence publishes the slot contents
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reads the next event for a consumer, if any.
+     *
+     * @param cursor The consumer's cursor, advanced on success.
+     * @param out Receives the event.
+     * @return true if an event was read, false if none is pending.
+     */
+    bool poll(Cursor &cursor, SignalEvent &out) const noexcept
+    {
+        while (true)
+        {
+            std::uint64_t h = head.load(std::memory_order_acquire);
+            if (cursor.next == h)
+            {
+                return false;
+            }
+
+            // Skip ahead if the producer has lapped this consumer
+            if (h - cursor.next > capacity)
+            {
+                cursor.lost += h - cursor.next - capacity;
+                cursor.next = h - capacity;
+            }
+
+            const Slot &slot = slots[cursor.next & (capacity - 1)];
+            std::uint64_t expected = 2 * cursor.next + 2;
+
+            std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before != expected)
+            {
+                continue; // Overwritten or mid-write; re-evaluate the head
+            }
+
+            out.signo = slot.signo.load(std::memory_order_relaxed);
+            out.code = slot.code.load(std::memory_order_relaxed);
+            out.pid = slot.pid.load(std::memory_order_relaxed);
+            out.uid = slot.uid.load(std::memory_order_relaxed);
+            out.value.sival_ptr =
+                reinterpret_cast<void *>(slot.value.load(std::memory_order_relaxed));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != before)
+            {
+                continue; // Torn read, the slot was reused underneath us
+            }
+
+            ++cursor.next;
+            return true;
+        }
+    }
+
+private:
+    /**
+     * @brief One ring entry guarded by its sequence number.
+     */
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<int> signo{0};
+        std::atomic<int> code{0};
+        std::atomic<pid_t> pid{0};
+        std::atomic<uid_t> uid{0};
+        std::atomic<std::uintptr_t> value{0};
+    };
+
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    /**
+     * @brief Producer sequence, on its own cache line so polling stays cheap.
+     */
+    alignas(64) std::atomic<std::uint64_t> head{0};
+
+    /**
+     * @brief Event storage.
+     */
+    alignas(64) Slot slots[capacity];
+};
+
+#endif // SIGNAL_EVENT_RING_HPP
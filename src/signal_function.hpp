@@ -0,0 +1,231 @@
+/**
+ * @file signal_function.hpp
+ * @brief Fixed-capacity, allocation-free callable wrapper for signal callbacks.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_FUNCTION_HPP
+#define SIGNAL_FUNCTION_HPP
+
+// Standard Libraries
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Default inline storage for SignalHandler callbacks, in bytes.
+ */
+static constexpr std::size_t signal_function_capacity = 64;
+
+template <typename Signature, std::size_t Capacity = signal_function_capacity>
+class SignalInplaceFunction;
+
+/**
+ * @brief A copyable callable stored entirely inside the object.
+ *
+ * @details
+ * Like `std::function`, but the target always lives in an inline buffer of
+ * `Capacity` bytes, so construction, copy and assignment never allocate.
+ * A callable that does not fit, or needs stricter alignment, fails to
+ * compile with a `static_assert` instead of falling back to the heap. That
+ * makes registration safe where malloc is not: memory-constrained code,
+ * or a child between `fork()` and `exec()`.
+ *
+ * A call is one indirect call through a per-type operations table, the
+ * same cost as `std::function`, with no null check for heap storage.
+ *
+ * @tparam R Return type.
+ * @tparam Args Parameter types.
+ * @tparam Capacity Inline storage in bytes.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class SignalInplaceFunction<R(Args...), Capacity>
+{
+public:
+    /**
+     * @brief Constructs an empty function.
+     */
+    SignalInplaceFunction() noexcept : ops(nullptr) {}
+
+    /**
+     * @brief Constructs an empty function.
+     */
+    SignalInplaceFunction(std::nullptr_t) noexcept : ops(nullptr) {}
+
+    /**
+     * @brief Stores a callable.
+     *
+     * @tparam F The callable type; must fit in `Capacity` bytes.
+     * @param f The callable.
+     */
+    template <typename F,
+              typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<D, SignalInplaceFunction>::value &&
+                                          std::is_invocable_r<R, D &, Args...>::value>>
+    SignalInplaceFunction(F &&f) : ops(nullptr)
+    {
+        static_assert(sizeof(D) <= Capacity,
+                      "Callable too large for SignalInplaceFunction; capture less or raise Capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t),
+                      "Callable over-aligned for SignalInplaceFunction");
+        static_assert(std::is_copy_constructible<D>::value,
+                      "SignalInplaceFunction requires a copyable callable");
+
+        if constexpr (std::is_pointer<std::remove_reference_t<F>>::value ||
+                      (std::is_class<D>::value && std::is_constructible<bool, const D &>::value &&
+                       !std::is_convertible<const D &, R (*)(Args...)>::value))
+        {
+            // A null function pointer (or empty std::function) stays empty
+            if (!f)
+            {
+                return;
+            }
+        }
+
+        ::new (static_cast<void *>(&storage)) D(std::forward<F>(f));
+        ops = &OpsFor<D>::table;
+    }
+
+    SignalInplaceFunction(const SignalInplaceFunction &other) : ops(nullptr)
+    {
+        if (other.ops != nullptr)
+        {
+            other.ops->copy(&storage, &other.storage);
+            ops = other.ops;
+        }
+    }
+
+    SignalInplaceFunction &operator=(const SignalInplaceFunction &other)
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.ops != nullptr)
+            {
+                other.ops->copy(&storage, &other.storage);
+                ops = other.ops;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroys the target, leaving the function empty.
+     *
+     * @return This object.
+     */
+    SignalInplaceFunction &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~SignalInplaceFunction()
+    {
+        reset();
+    }
+
+    /**
+     * @brief Reports whether a callable is stored.
+     *
+     * @return true if callable.
+     */
+    explicit operator bool() const noexcept
+    {
+        return ops != nullptr;
+    }
+
+    /**
+     * @brief Calls the target; the function must not be empty.
+     *
+     * @param args The arguments.
+     * @return The target's result.
+     */
+    R operator()(Args... args) const
+    {
+        return ops->invoke(&storage, std::forward<Args>(args)...);
+    }
+
+private:
+    /**
+     * @brief Type-specific operations.
+     */
+    struct Ops
+    {
+        R (*invoke)(const void *, Args &&...);  ///< Calls the target.
+        void (*copy)(void *, const void *);     ///< Copy-constructs into raw storage.
+        void (*destroy)(void *) noexcept;       ///< Destroys the target.
+    };
+
+    /**
+     * @brief The operations table for one callable type.
+     */
+    template <typename D>
+    struct OpsFor
+    {
+        static R invoke(const void *p, Args &&...args)
+        {
+            // Mutable lambdas are allowed, as with std::function
+            return (*const_cast<D *>(static_cast<const D *>(p)))(std::forward<Args>(args)...);
+        }
+
+        static void copy(void *dst, const void *src)
+        {
+            ::new (dst) D(*static_cast<const D *>(src));
+        }
+
+        static void destroy(void *p) noexcept
+        {
+            static_cast<D *>(p)->~D();
+        }
+
+        static constexpr Ops table = {&OpsFor::invoke, &OpsFor::copy, &OpsFor::destroy};
+    };
+
+    /**
+     * @brief Destroys the target, if any.
+     */
+    void reset() noexcept
+    {
+        if (ops != nullptr)
+        {
+            ops->destroy(&storage);
+            ops = nullptr;
+        }
+    }
+
+    /**
+     * @brief Inline storage for the target.
+     */
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+
+    /**
+     * @brief Operations for the stored type, nullptr when empty.
+     */
+    const Ops *ops;
+};
+
+#endif // SIGNAL_FUNCTION_HPP
@@ -0,0 +1,346 @@
+/**
+ * @file signal_grace.cpp
+ * @brief Termination grace budget with forced exit before the supervisor's SIGKILL.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_grace.hpp"
+#include "signal_crash.hpp"
+#include "signal_event_log.hpp"
+
+// Standard libraries
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// System libraries
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <cstdio> // For perror()
+#endif
+
+/**
+ * @brief Budget in nanoseconds, -1 while not configured.
+ */
+static std::atomic<std::int64_t> grace_budget_ns{-1};
+
+/**
+ * @brief Margin in nanoseconds.
+ */
+static std::atomic<std::int64_t> grace_margin_ns{0};
+
+/**
+ * @brief CLOCK_MONOTONIC time of the forced exit, 0 until `begin()`.
+ */
+static std::atomic<std::int64_t> grace_deadline_ns{0};
+
+/**
+ * @brief Serializes `begin()`, `cancel()` and the action.
+ */
+static std::mutex grace_mutex;
+
+/**
+ * @brief The escalation timer, valid while `grace_timer_armed`.
+ */
+static timer_t grace_timer;
+
+/**
+ * @brief Whether `grace_timer` exists.
+ */
+static bool grace_timer_armed = false;
+
+/**
+ * @brief Action run before the forced exit.
+ */
+static SignalGrace::Action grace_action;
+
+/**
+ * @brief Reads CLOCK_MONOTONIC.
+ *
+ * @return Nanoseconds since an arbitrary epoch.
+ */
+static std::int64_t monotonicNow()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Escalation, on the timer's own thread.
+ *
+ * @details The record carries SIGKILL, the signal it pre-empts, so a
+ * supervisor reading the log can attribute the exit.
+ *
+ * @param value Unused.
+ */
+static void onGraceExpired(sigval value)
+{
+    (void)value;
+
+    SignalEventLog *log = SignalCrashHandler::eventLog();
+    if (log != nullptr)
+    {
+        siginfo_t info;
+        std::memset(&info, 0, sizeof(info));
+        info.si_signo = SIGKILL;
+        info.si_code = SI_TIMER;
+        info.si_pid = getpid();
+        log->append(SignalEventLog::Kind::Escalation, info, static_cast<int>(syscall(SYS_gettid)));
+        log->sync();
+    }
+
+    static const char message[] = "Termination grace budget exhausted, exiting.\n";
+    ssize_t ignored = write(STDERR_FILENO, message, sizeof(message) - 1);
+    (void)ignored;
+
+    SignalGrace::Action action;
+    {
+        std::lock_guard<std::mutex> lock(grace_mutex);
+        action = grace_action;
+    }
+    if (action)
+    {
+        action();
+    }
+
+    std::_Exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Sets the budget.
+ *
+ * @param budget The grace period.
+ * @param margin The head start.
+ * @return `true` if stored.
+ */
+bool SignalGrace::configure(std::chrono::milliseconds budget, std::chrono::milliseconds margin)
+{
+    if (budget <= std::chrono::milliseconds::zero() || margin < std::chrono::milliseconds::zero())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(grace_mutex);
+    if (grace_deadline_ns.load() != 0)
+    {
+        return false;
+    }
+
+    grace_margin_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(margin).count());
+    grace_budget_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(budget).count());
+    return true;
+}
+
+/**
+ * @brief Sets the budget from the environment.
+ *
+ * @param name The variable.
+ * @param margin The head start.
+ * @return `true` if a valid period was found and stored.
+ */
+bool SignalGrace::configureFromEnv(const char *name, std::chrono::milliseconds margin)
+{
+    const char *text = name != nullptr ? std::getenv(name) : nullptr;
+    if (text == nullptr || *text == '\0')
+    {
+        return false;
+    }
+
+    errno = 0;
+    char *end = nullptr;
+    double seconds = std::strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || !(seconds > 0.0) || seconds > 1e6)
+    {
+        return false;
+    }
+
+    return configure(std::chrono::milliseconds(static_cast<std::int64_t>(std::llround(seconds * 1000.0))),
+                     margin);
+}
+
+/**
+ * @brief Reports whether a budget is set.
+ *
+ * @return `true` if configured.
+ */
+bool SignalGrace::configured()
+{
+    return grace_budget_ns.load(std::memory_order_relaxed) > 0;
+}
+
+/**
+ * @brief Starts the countdown and arms the escalation timer.
+ *
+ * @details The deadline is published even if the timer cannot be created,
+ * so `remaining()` still works; only the forced exit is lost.
+ *
+ * @return `true` if this call started it.
+ */
+bool SignalGrace::begin()
+{
+    // The common case, a stop signal without a budget, takes no lock
+    std::int64_t budget = grace_budget_ns.load(std::memory_order_relaxed);
+    if (budget <= 0 || grace_deadline_ns.load(std::memory_order_relaxed) != 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(grace_mutex);
+    if (grace_deadline_ns.load() != 0)
+    {
+        return false;
+    }
+
+    std::int64_t delay = budget - grace_margin_ns.load();
+    if (delay < 1)
+    {
+        delay = 1;
+    }
+    std::int64_t deadline = monotonicNow() + delay;
+    grace_deadline_ns.store(deadline);
+
+    sigevent sev;
+    std::memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD;
+    sev.sigev_notify_function = &onGraceExpired;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &grace_timer) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_create");
+#endif
+        return true;
+    }
+
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(deadline / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(deadline % 1000000000);
+    if (timer_settime(grace_timer, TIMER_ABSTIME, &spec, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_settime");
+#endif
+        timer_delete(grace_timer);
+        return true;
+    }
+
+    grace_timer_armed = true;
+    return true;
+}
+
+/**
+ * @brief Reports whether the countdown is running.
+ *
+ * @return `true` after `begin()`.
+ */
+bool SignalGrace::started()
+{
+    return grace_deadline_ns.load(std::memory_order_relaxed) != 0;
+}
+
+/**
+ * @brief Returns the time left before the forced exit.
+ *
+ * @details One relaxed load and a vDSO clock read once started, cheap
+ * enough to poll from a worker's loop.
+ *
+ * @return The time left.
+ */
+std::chrono::milliseconds SignalGrace::remaining()
+{
+    std::int64_t deadline = grace_deadline_ns.load(std::memory_order_relaxed);
+    std::int64_t left;
+    if (deadline != 0)
+    {
+        left = deadline - monotonicNow();
+    }
+    else
+    {
+        std::int64_t budget = grace_budget_ns.load(std::memory_order_relaxed);
+        if (budget <= 0)
+        {
+            return std::chrono::milliseconds::max();
+        }
+        left = budget - grace_margin_ns.load(std::memory_order_relaxed);
+    }
+
+    if (left <= 0)
+    {
+        return std::chrono::milliseconds::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(left));
+}
+
+/**
+ * @brief Deletes the escalation timer and clears the deadline.
+ *
+ * @details An expiry already running on the timer thread cannot be
+ * recalled; `timer_delete()` only prevents one that has not fired.
+ */
+void SignalGrace::cancel()
+{
+    std::lock_guard<std::mutex> lock(grace_mutex);
+    if (grace_timer_armed)
+    {
+        timer_delete(grace_timer);
+        grace_timer_armed = false;
+    }
+    grace_deadline_ns.store(0);
+}
+
+/**
+ * @brief Sets the escalation action.
+ *
+ * @param action The action, or empty.
+ */
+void SignalGrace::setEscalation(const Action &action)
+{
+    std::lock_guard<std::mutex> lock(grace_mutex);
+    grace_action = action;
+}
+
+/**
+ * @brief Resets the countdown in a forked child.
+ *
+ * @details Timers are not inherited, and a thread that held the lock at
+ * the fork is gone.
+ */
+void SignalGrace::afterFork()
+{
+    new (&grace_mutex) std::mutex();
+    grace_timer_armed = false;
+    grace_deadline_ns.store(0);
+}
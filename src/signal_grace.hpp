@@ -0,0 +1,152 @@
+/**
+ * @file signal_grace.hpp
+ * @brief Termination grace budget with forced exit before the supervisor's SIGKILL.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_GRACE_HPP
+#define SIGNAL_GRACE_HPP
+
+// Standard Libraries
+#include <chrono>
+
+// Project libraries
+#include "signal_function.hpp"
+
+/**
+ * @brief Process-wide time budget for a graceful termination.
+ *
+ * @details
+ * Supervisors such as the kubelet send SIGTERM, wait a grace period
+ * (`terminationGracePeriodSeconds`) and then send SIGKILL, which leaves no
+ * chance to record anything. The budget mirrors that period. `begin()`,
+ * called by SignalHandler on the first stop signal, starts the clock.
+ * `remaining()` tells workers how long they have left, so they can decide
+ * whether to finish or abandon a batch in flight.
+ *
+ * When `budget - margin` has elapsed, a POSIX timer with `SIGEV_THREAD`
+ * calls the escalation on a thread of its own. It appends an `Escalation`
+ * record to the event log attached to SignalCrashHandler and syncs the
+ * log. Next it writes a line to stderr and runs the optional action. Then
+ * it calls `std::_Exit(EXIT_FAILURE)`. The timer depends on no other
+ * thread, so it fires even after `SignalHandler::stop()` or while the
+ * signal thread is blocked.
+ *
+ * The grace period itself is not visible from inside a container, so it
+ * is configured here or through an environment variable set in the pod
+ * spec, e.g. `SIGNAL_GRACE_PERIOD=30`.
+ */
+class SignalGrace
+{
+public:
+    /**
+     * @brief Environment variable read by `configureFromEnv()`, in seconds.
+     */
+    static constexpr const char *default_env = "SIGNAL_GRACE_PERIOD";
+
+    /**
+     * @brief Default head start taken on the supervisor's SIGKILL.
+     */
+    static constexpr std::chrono::milliseconds default_margin{2000};
+
+    /**
+     * @brief Runs just before the forced exit; should not block.
+     */
+    using Action = SignalInplaceFunction<void()>;
+
+    SignalGrace() = delete;
+
+    /**
+     * @brief Sets the budget.
+     *
+     * @param budget The supervisor's grace period.
+     * @param margin How long before the end of `budget` to escalate.
+     * @return false once the budget has started, or if `budget` is not positive.
+     */
+    static bool configure(std::chrono::milliseconds budget,
+                          std::chrono::milliseconds margin = default_margin);
+
+    /**
+     * @brief Sets the budget from an environment variable.
+     *
+     * @param name Variable holding the grace period in seconds; fractions allowed.
+     * @param margin How long before the end of the period to escalate.
+     * @return false if the variable is unset or invalid, or the budget has started.
+     */
+    static bool configureFromEnv(const char *name = default_env,
+                                 std::chrono::milliseconds margin = default_margin);
+
+    /**
+     * @brief Reports whether a budget is set.
+     *
+     * @return true after a successful `configure()`.
+     */
+    static bool configured();
+
+    /**
+     * @brief Starts the countdown; only the first call has an effect.
+     *
+     * @return true if this call started it.
+     */
+    static bool begin();
+
+    /**
+     * @brief Reports whether the countdown is running.
+     *
+     * @return true between `begin()` and `cancel()`.
+     */
+    static bool started();
+
+    /**
+     * @brief Returns the time left before the forced exit.
+     *
+     * @return The time left, zero once past; `budget - margin` before
+     *         `begin()`; `milliseconds::max()` with no budget.
+     */
+    static std::chrono::milliseconds remaining();
+
+    /**
+     * @brief Stops the countdown, e.g. once shutdown completed in time.
+     */
+    static void cancel();
+
+    /**
+     * @brief Sets the action run before the forced exit.
+     *
+     * @details Runs on the timer thread, e.g. to call
+     * `SignalShutdown::escalate()` or to log. The process exits when it
+     * returns.
+     *
+     * @param action The action; empty for none.
+     */
+    static void setEscalation(const Action &action);
+
+    /**
+     * @brief Forgets the countdown in a forked child, whose timers are gone.
+     */
+    static void afterFork();
+};
+
+#endif // SIGNAL_GRACE_HPP
@@ -0,0 +1,469 @@
+/**
+ * @file signal_group.cpp
+ * @brief Broadcast signals to a pool of child processes and collect acknowledgements.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_group.hpp"
+
+// Standard libraries
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdio>
+
+// System libraries
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Shared (not process-private) futex call on a 32-bit atomic.
+ *
+ * @param word The atomic to wait on or wake.
+ * @param op FUTEX_WAIT or FUTEX_WAKE.
+ * @param val Expected value for a wait, or the number of waiters to wake.
+ * @param timeout Relative timeout for a wait, or nullptr.
+ * @return The raw syscall result.
+ */
+static long sharedFutex(const std::atomic<std::uint32_t> *word, int op,
+                        std::uint32_t val, const timespec *timeout)
+{
+    return syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(word),
+                   op, val, timeout, nullptr, 0);
+}
+
+/**
+ * @brief Constructs an empty, unmapped group.
+ */
+SignalProcessGroup::SignalProcessGroup()
+    : shared(nullptr),
+      group_id(0),
+      members(0)
+{
+    pidfds.fill(-1);
+}
+
+/**
+ * @brief Destructor; closes descriptors and unmaps the shared state.
+ */
+SignalProcessGroup::~SignalProcessGroup()
+{
+    close();
+}
+
+/**
+ * @brief Maps the shared acknowledgement state.
+ *
+ * @details `MAP_SHARED | MAP_ANONYMOUS` memory is inherited by `fork()`
+ * and stays shared, so children can acknowledge without any descriptor.
+ *
+ * @return `true` if mapped.
+ */
+bool SignalProcessGroup::create()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (shared != nullptr)
+    {
+        return true;
+    }
+
+    void *addr = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("mmap(process group)");
+#endif
+        return false;
+    }
+
+    // Fresh anonymous pages are zero: no members, nothing outstanding
+    shared = static_cast<Shared *>(addr);
+    for (auto &word : shared->bits)
+    {
+        word.store(~std::uint64_t{0}, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+/**
+ * @brief Closes every pidfd and unmaps the shared state.
+ */
+void SignalProcessGroup::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int &fd : pidfds)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    members = 0;
+
+    if (shared != nullptr)
+    {
+        munmap(shared, sizeof(Shared));
+        shared = nullptr;
+    }
+}
+
+/**
+ * @brief Closes the pidfds a child inherited.
+ */
+void SignalProcessGroup::enterChild()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int &fd : pidfds)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+/**
+ * @brief Adds a child.
+ *
+ * @details A member added mid-round is not part of that round: its bit
+ * starts set, so `pending()` and `waitAcks()` ignore it until the next
+ * `broadcast()`.
+ *
+ * @param pid The child.
+ * @return The member index, or -1.
+ */
+int SignalProcessGroup::add(pid_t pid)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (shared == nullptr || pid <= 0)
+    {
+        return -1;
+    }
+
+    long free_slot = -1;
+    for (std::size_t i = 0; i < max_members; ++i)
+    {
+        pid_t member = shared->pids[i].load(std::memory_order_relaxed);
+        if (member == pid)
+        {
+            return -1;
+        }
+        if (member == 0 && free_slot < 0)
+        {
+            free_slot = static_cast<long>(i);
+        }
+    }
+    if (free_slot < 0)
+    {
+        return -1;
+    }
+
+    std::size_t index = static_cast<std::size_t>(free_slot);
+#ifdef SYS_pidfd_open
+    pidfds[index] = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#endif
+    shared->bits[index / 64].fetch_or(std::uint64_t{1} << (index % 64));
+    shared->pids[index].store(pid, std::memory_order_release);
+    ++members;
+    return static_cast<int>(index);
+}
+
+/**
+ * @brief Removes a child.
+ *
+ * @param pid The child.
+ * @return `true` if it was a member.
+ */
+bool SignalProcessGroup::remove(pid_t pid)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (shared == nullptr || pid <= 0)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < max_members; ++i)
+    {
+        if (shared->pids[i].load(std::memory_order_relaxed) != pid)
+        {
+            continue;
+        }
+
+        // A child that is gone has nothing left to drain
+        markDone(i);
+        shared->pids[i].store(0, std::memory_order_release);
+        if (pidfds[i] >= 0)
+        {
+            ::close(pidfds[i]);
+            pidfds[i] = -1;
+        }
+        --members;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Broadcasts with `killpg()` instead of pidfds.
+ *
+ * @param pgid The process group, or 0.
+ */
+void SignalProcessGroup::setProcessGroup(pid_t pgid)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    group_id = pgid;
+}
+
+/**
+ * @brief Signals every member and starts a new acknowledgement round.
+ *
+ * @details
+ * The round is reset before any signal is sent, so an acknowledgement can
+ * never be lost to the reset. With a process group one `killpg()` reaches
+ * everyone; otherwise each member gets `pidfd_send_signal()`, or `kill()`
+ * if its pidfd could not be opened.
+ *
+ * @param signum The signal.
+ * @return The number of members signalled, or -1.
+ */
+int SignalProcessGroup::broadcast(int signum)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (shared == nullptr)
+    {
+        return -1;
+    }
+
+    // New round: every current member outstanding, nothing acknowledged
+    shared->acked.store(0, std::memory_order_relaxed);
+    for (std::size_t w = 0; w < bitmap_words; ++w)
+    {
+        std::uint64_t outstanding = 0;
+        for (std::size_t b = 0; b < 64; ++b)
+        {
+            if (shared->pids[w * 64 + b].load(std::memory_order_relaxed) != 0)
+            {
+                outstanding |= std::uint64_t{1} << b;
+            }
+        }
+        shared->bits[w].store(~outstanding, std::memory_order_relaxed);
+    }
+    shared->expected.store(static_cast<std::uint32_t>(members), std::memory_order_relaxed);
+    shared->round.fetch_add(1, std::memory_order_release);
+
+    // A master already in waitAcks() must see the new round, even an empty one
+    sharedFutex(&shared->acked, FUTEX_WAKE, INT_MAX, nullptr);
+
+    if (group_id > 0)
+    {
+        if (killpg(group_id, signum) != 0)
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("killpg");
+#endif
+            return 0;
+        }
+        return static_cast<int>(members);
+    }
+
+    int sent = 0;
+    for (std::size_t i = 0; i < max_members; ++i)
+    {
+        pid_t pid = shared->pids[i].load(std::memory_order_relaxed);
+        if (pid == 0)
+        {
+            continue;
+        }
+
+        long ret = -1;
+#ifdef SYS_pidfd_send_signal
+        if (pidfds[i] >= 0)
+        {
+            ret = syscall(SYS_pidfd_send_signal, pidfds[i], signum, nullptr, 0);
+        }
+        else
+#endif
+        {
+            ret = kill(pid, signum);
+        }
+
+        if (ret == 0)
+        {
+            ++sent;
+        }
+    }
+    return sent;
+}
+
+/**
+ * @brief Acknowledges the current round from a child.
+ *
+ * @return `true` if this call recorded the acknowledgement.
+ */
+bool SignalProcessGroup::ack()
+{
+    if (shared == nullptr)
+    {
+        return false;
+    }
+
+    pid_t self = getpid();
+    for (std::size_t i = 0; i < max_members; ++i)
+    {
+        if (shared->pids[i].load(std::memory_order_acquire) == self)
+        {
+            return markDone(i);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Waits for the current round to complete.
+ *
+ * @details Sleeps on the shared `acked` futex. Only the final
+ * acknowledgement issues a wake, so the master is woken once per round.
+ * Called before the first `broadcast()`, it also waits for that round to
+ * start, so a master may wait without racing its own signal thread.
+ *
+ * @param timeout Maximum time to wait.
+ * @return `true` if every member acknowledged in time.
+ */
+bool SignalProcessGroup::waitAcks(std::chrono::milliseconds timeout)
+{
+    if (shared == nullptr)
+    {
+        return false;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point deadline = clock::now() + timeout;
+
+    while (true)
+    {
+        std::uint32_t seen = shared->acked.load(std::memory_order_acquire);
+        if (shared->round.load(std::memory_order_acquire) != 0 &&
+            seen >= shared->expected.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+
+        auto remaining = deadline - clock::now();
+        if (remaining <= clock::duration::zero())
+        {
+            return false;
+        }
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        sharedFutex(&shared->acked, FUTEX_WAIT, seen, &ts);
+    }
+}
+
+/**
+ * @brief Returns the acknowledgements received this round.
+ *
+ * @return The count.
+ */
+std::size_t SignalProcessGroup::acked() const
+{
+    return shared != nullptr ? shared->acked.load(std::memory_order_acquire) : 0;
+}
+
+/**
+ * @brief Returns the members still outstanding this round.
+ *
+ * @return Their pids.
+ */
+std::vector<pid_t> SignalProcessGroup::pending() const
+{
+    std::vector<pid_t> result;
+    if (shared == nullptr)
+    {
+        return result;
+    }
+
+    for (std::size_t w = 0; w < bitmap_words; ++w)
+    {
+        std::uint64_t outstanding = ~shared->bits[w].load(std::memory_order_acquire);
+        while (outstanding != 0)
+        {
+            std::size_t i = w * 64 + static_cast<std::size_t>(__builtin_ctzll(outstanding));
+            outstanding &= outstanding - 1;
+            pid_t pid = shared->pids[i].load(std::memory_order_relaxed);
+            if (pid != 0)
+            {
+                result.push_back(pid);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the number of members.
+ *
+ * @return The count.
+ */
+std::size_t SignalProcessGroup::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return members;
+}
+
+/**
+ * @brief Marks a member done.
+ *
+ * @details One atomic OR on the member's bitmap word; only the caller that
+ * flips the bit counts it, and only the count that reaches `expected`
+ * issues the futex wake.
+ *
+ * @param index The member.
+ * @return `true` if this call set the bit.
+ */
+bool SignalProcessGroup::markDone(std::size_t index)
+{
+    std::uint64_t bit = std::uint64_t{1} << (index % 64);
+    if ((shared->bits[index / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) != 0)
+    {
+        return false;
+    }
+
+    std::uint32_t count = shared->acked.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (count >= shared->expected.load(std::memory_order_acquire))
+    {
+        sharedFutex(&shared->acked, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+    return true;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file signal_group.hpp
+ * @brief Broadcast signals to a pool of child processes and collect acknowledgements.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_GROUP_HPP
+#define SIGNAL_GROUP_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// System libraries
+#include <sys/types.h>
+
+/**
+ * @brief A set of child processes that receive the master's signals together.
+ *
+ * @details
+ * Create the group before forking; its acknowledgement state lives in an
+ * anonymous shared mapping that every child inherits. The master then adds
+ * each child's pid. `add()` opens a pidfd for it, so a signal can never hit
+ * an unrelated process that reused the pid.
+ *
+ * `broadcast()` resets the acknowledgement bitmap and signals every member
+ * in one pass: one `killpg()` if a process group is set, otherwise one
+ * `pidfd_send_signal()` per member. Each child calls `ack()` once it has
+ * drained, which sets its bit with one atomic OR. The last acknowledgement
+ * wakes the master, which sleeps in `waitAcks()` on a cross-process futex,
+ * so the master wakes once, not once per child.
+ *
+ * A member removed before acknowledging (for instance when
+ * SignalChildReaper reports its exit) counts as acknowledged.
+ */
+class SignalProcessGroup
+{
+public:
+    /**
+     * @brief Maximum number of members.
+     */
+    static constexpr std::size_t max_members = 1024;
+
+    SignalProcessGroup();
+    ~SignalProcessGroup();
+
+    // Owns a mapping and descriptors
+    SignalProcessGroup(const SignalProcessGroup &) = delete;
+    SignalProcessGroup &operator=(const SignalProcessGroup &) = delete;
+
+    /**
+     * @brief Maps the shared acknowledgement state; call before forking.
+     *
+     * @return true on success or if already created.
+     */
+    bool create();
+
+    /**
+     * @brief Closes every pidfd and unmaps the shared state.
+     */
+    void close();
+
+    /**
+     * @brief Closes the pidfds a child inherited from the master.
+     *
+     * @details Call in each child right after `fork()`; `ack()` keeps working.
+     */
+    void enterChild();
+
+    /**
+     * @brief Adds a child (master side).
+     *
+     * @param pid The child.
+     * @return The member index, or -1 if full, not created or already a member.
+     */
+    int add(pid_t pid);
+
+    /**
+     * @brief Removes a child; an outstanding acknowledgement counts as given.
+     *
+     * @param pid The child.
+     * @return true if it was a member.
+     */
+    bool remove(pid_t pid);
+
+    /**
+     * @brief Broadcasts with `killpg()` instead of per-member pidfds.
+     *
+     * @param pgid The process group, or 0 to go back to pidfds.
+     */
+    void setProcessGroup(pid_t pgid);
+
+    /**
+     * @brief Signals every member and starts a new acknowledgement round.
+     *
+     * @param signum The signal.
+     * @return The number of members signalled, or -1 if not created.
+     */
+    int broadcast(int signum);
+
+    /**
+     * @brief Acknowledges the current round (child side).
+     *
+     * @return true if the calling process is a member and had not acknowledged yet.
+     */
+    bool ack();
+
+    /**
+     * @brief Waits until every member of the current round has acknowledged.
+     *
+     * @details Before the first `broadcast()` this also waits for it.
+     *
+     * @param timeout Maximum time to wait.
+     * @return true if all acknowledged in time.
+     */
+    bool waitAcks(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Returns the acknowledgements received in the current round.
+     *
+     * @return The count.
+     */
+    std::size_t acked() const;
+
+    /**
+     * @brief Returns the members that have not acknowledged the current round.
+     *
+     * @return Their pids.
+     */
+    std::vector<pid_t> pending() const;
+
+    /**
+     * @brief Returns the number of members.
+     *
+     * @return The count.
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @brief Words in the acknowledgement bitmap.
+     */
+    static constexpr std::size_t bitmap_words = max_members / 64;
+
+    /**
+     * @brief State shared with the children through the mapping.
+     */
+    struct Shared
+    {
+        alignas(64) std::atomic<std::uint32_t> acked;    ///< Acks this round; futex word.
+        std::atomic<std::uint32_t> expected;             ///< Members signalled this round.
+        std::atomic<std::uint32_t> round;                ///< Broadcast counter.
+        alignas(64) std::atomic<std::uint64_t> bits[bitmap_words]; ///< Set once acknowledged.
+        std::atomic<std::int32_t> pids[max_members];     ///< Member pids, 0 if free.
+    };
+
+    /**
+     * @brief Marks a member done and wakes the master on the last one.
+     *
+     * @param index The member.
+     * @return true if this call set the member's bit.
+     */
+    bool markDone(std::size_t index);
+
+    /**
+     * @brief The shared mapping, nullptr until `create()`.
+     */
+    Shared *shared;
+
+    /**
+     * @brief pidfd per member, -1 if none (master side).
+     */
+    std::array<int, max_members> pidfds;
+
+    /**
+     * @brief Process group used by `broadcast()`, 0 for pidfds.
+     */
+    pid_t group_id;
+
+    /**
+     * @brief Number of members.
+     */
+    std::size_t members;
+
+    /**
+     * @brief Serializes the master-side operations.
+     */
+    mutable std::mutex mutex;
+};
+
+#endif // SIGNAL_GROUP_HPP
@@ -29,64 +29,178 @@
 
 // Project libraries
 #include "signal_handler.hpp"
+#include "signal_backtrace.hpp"
 
 // Standard libraries
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 
 // System Libraries
-#include <pthread.h>
-#include <sched.h>
+#include <fcntl.h>  // O_CLOEXEC
+#include <limits.h> // PTHREAD_STACK_MIN
 #include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #ifdef DEBUG_SIGNAL_HANDLER
 #include <iostream> // Debug printing
-#include <cstring>  // For strerror()
 #endif
 
+// Out-of-line definitions for ODR-used static constexpr members
+constexpr std::array<SignalHandler::SignalEntry, SignalHandler::signal_limit> SignalHandler::signal_table;
+constexpr std::uint64_t SignalHandler::handled_mask;
+
+/**
+ * @brief Handler installed on the claimed wake-up signal.
+ *
+ * @details Marks the signal as taken for anyone scanning for a free one,
+ * and turns a stray delivery to an unblocked thread into a no-op instead
+ * of the default action (terminate).
+ */
+static void wakeNoop(int)
+{
+}
+
+/**
+ * @brief Claims a free real-time signal for wake-ups, once per process.
+ *
+ * @details
+ * Searches down from SIGRTMAX, since applications and libraries that pick
+ * real-time signals conventionally count up from SIGRTMIN. A signal is free
+ * if its disposition is still SIG_DFL; claiming installs `wakeNoop()` so a
+ * second search, ours or another library's, skips it.
+ *
+ * @return The claimed signal, or SIGUSR1 if every real-time signal is taken.
+ */
+static int claimWakeSignal()
+{
+    for (int sig = SIGRTMAX; sig >= SIGRTMIN && sig < SignalHandler::signal_limit; --sig)
+    {
+        struct sigaction current;
+        if (sigaction(sig, nullptr, &current) != 0 || current.sa_handler != SIG_DFL ||
+            (current.sa_flags & SA_SIGINFO) != 0)
+        {
+            continue;
+        }
+
+        struct sigaction sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = wakeNoop;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        if (sigaction(sig, &sa, nullptr) == 0)
+        {
+            return sig;
+        }
+    }
+
+#ifdef DEBUG_SIGNAL_HANDLER
+    std::cerr << "No free real-time signal, waking with SIGUSR1." << std::endl;
+#endif
+    return SIGUSR1;
+}
+
+/**
+ * @brief Builds a `sigset_t` from a `signalBit()` mask.
+ *
+ * @param mask The signals to include.
+ * @param set Receives the signal set.
+ */
+static void maskToSet(std::uint64_t mask, sigset_t &set)
+{
+    sigemptyset(&set);
+    for (int sig = 1; sig < SignalHandler::signal_limit; ++sig)
+    {
+        if (mask & SignalHandler::signalBit(sig))
+        {
+            sigaddset(&set, sig);
+        }
+    }
+}
+
 /**
- * @brief Mapping of signals to their names and fatality flags.
+ * @brief Reports whether a record is the handler's own wake-up signal.
  *
- * This static unordered_map holds a mapping between signal numbers (keys) and a pair containing:
- * - A textual representation of the signal name.
- * - A boolean flag indicating whether the signal is considered fatal (true) or non-fatal (false).
+ * @details `pthread_kill()` from this process arrives with our own PID, as
+ * SI_TKILL on older kernels and as SI_USER on newer ones; anything else,
+ * such as a timer tick or a signal from another process, is a real
+ * signal, even on the same number.
+ *
+ * @param info The received signal information.
+ * @return true if the record was sent by `wake()` or `stop()`.
+ */
+static bool isWakeSignal(const siginfo_t &info)
+{
+    return info.si_signo == SignalHandler::wakeSignal() &&
+           (info.si_code == SI_TKILL || info.si_code == SI_USER) && info.si_pid == getpid();
+}
+
+/**
+ * @brief Translates a signalfd record into a `siginfo_t`.
  *
- * The mapping includes the following signals:
- * - SIGUSR1: User-defined signal 1 (non-fatal).
- * - SIGINT: Interrupt from keyboard (non-fatal).
- * - SIGTERM: Termination signal (non-fatal).
- * - SIGQUIT: Quit from keyboard (non-fatal).
- * - SIGHUP: Hangup detected on controlling terminal (non-fatal).
- * - SIGSEGV: Invalid memory reference (fatal).
- * - SIGBUS: Bus error (fatal).
- * - SIGFPE: Floating-point exception (fatal).
- * - SIGILL: Illegal instruction (fatal).
- * - SIGABRT: Abort signal (fatal).
+ * @details The `siginfo_t` fields share a union, so only the members that
+ * the record's origin defines are written; filling them all would let
+ * `si_addr` overwrite the sender's pid and uid, and the payload overwrite
+ * a child's status.
  *
- * @note This map is a static member of the SignalHandler class.
+ * @param fdsi The record read from the signalfd.
+ * @param info Receives the translated record.
  */
-const std::unordered_map<int, std::pair<std::string_view, bool>> SignalHandler::signal_map = {
-    //{SIGUSR1, {"SIGUSR1", false}},
-    {SIGINT, {"SIGINT", false}},
-    {SIGTERM, {"SIGTERM", false}},
-    {SIGQUIT, {"SIGQUIT", false}},
-    {SIGHUP, {"SIGHUP", false}},
-    {SIGSEGV, {"SIGSEGV", true}},
-    {SIGBUS, {"SIGBUS", true}},
-    {SIGFPE, {"SIGFPE", true}},
-    {SIGILL, {"SIGILL", true}},
-    {SIGABRT, {"SIGABRT", true}}};
+static void fromSignalFd(const signalfd_siginfo &fdsi, siginfo_t &info)
+{
+    std::memset(&info, 0, sizeof(siginfo_t));
+    info.si_signo = static_cast<int>(fdsi.ssi_signo);
+    info.si_errno = fdsi.ssi_errno;
+    info.si_code = fdsi.ssi_code;
+
+    if (info.si_code == SI_TIMER)
+    {
+        info.si_timerid = static_cast<int>(fdsi.ssi_tid);
+        info.si_overrun = fdsi.ssi_overrun;
+        info.si_value.sival_ptr = reinterpret_cast<void *>(fdsi.ssi_ptr);
+    }
+    else if (info.si_code <= 0)
+    {
+        // Sent by a process: kill(), tgkill(), sigqueue() and friends
+        info.si_pid = static_cast<pid_t>(fdsi.ssi_pid);
+        info.si_uid = static_cast<uid_t>(fdsi.ssi_uid);
+        info.si_value.sival_ptr = reinterpret_cast<void *>(fdsi.ssi_ptr);
+    }
+    else if (info.si_signo == SIGCHLD)
+    {
+        info.si_pid = static_cast<pid_t>(fdsi.ssi_pid);
+        info.si_uid = static_cast<uid_t>(fdsi.ssi_uid);
+        info.si_status = fdsi.ssi_status;
+        info.si_utime = static_cast<clock_t>(fdsi.ssi_utime);
+        info.si_stime = static_cast<clock_t>(fdsi.ssi_stime);
+    }
+    else if (info.si_signo == SIGILL || info.si_signo == SIGFPE || info.si_signo == SIGSEGV ||
+             info.si_signo == SIGBUS || info.si_signo == SIGTRAP)
+    {
+        info.si_addr = reinterpret_cast<void *>(fdsi.ssi_addr);
+    }
+    else if (info.si_signo == SIGPOLL)
+    {
+        info.si_band = fdsi.ssi_band;
+        info.si_fd = fdsi.ssi_fd;
+    }
+}
 
 /**
- * @brief Block all signals registered in SignalHandler::signal_map.
- * @details Constructs a signal set by iterating over the signal_map from the
- *          SignalHandler class and blocks all the signals using pthread_sigmask.
+ * @brief Block all signals marked handled in SignalHandler::signal_table.
+ * @details Uses the precomputed signal set from the SignalHandler class and
+ *          blocks all the signals using pthread_sigmask.
  *
  *          This is commonly used in multithreaded environments to delegate
  *          signal handling to a dedicated thread, while blocking signal
  *          delivery to others.
  *
- * @note Only blocks signals listed in SignalHandler::signal_map.
+ * @note Only blocks signals marked handled in SignalHandler::signal_table.
  * @note Requires linking with -pthread.
  *
  * @throws None, but will print an error to stderr if pthread_sigmask fails,
@@ -94,30 +208,24 @@ const std::unordered_map<int, std::pair<std::string_view, bool>> SignalHandler::
  */
 void block_signals()
 {
-    sigset_t blockset;
+    // Remembered for SignalHandler::prepareExec()
+    SignalRegistry::instance().saveOriginalMask();
 
-    // Initialize the signal set to empty
-    if (sigemptyset(&blockset) != 0)
-    {
-#ifdef DEBUG_SIGNAL_HANDLER
-        perror("sigemptyset");
-#endif
-        return;
-    }
+    sigset_t blockset = SignalHandler::handledSignals();
 
-    // Add all signals defined in the SignalHandler's map
-    for (const auto &entry : SignalHandler::signal_map)
+    // Blocked fault signals would bypass the crash path, so leave them alone
+    if (SignalCrashHandler::installed())
     {
-        if (sigaddset(&blockset, entry.first) != 0)
+        for (int sig = 1; sig < SignalHandler::signal_limit; ++sig)
         {
-#ifdef DEBUG_SIGNAL_HANDLER
-            perror("sigaddset");
-#endif
-            // Continue attempting to add remaining signals
+            if (SignalCrashHandler::fault_mask & SignalHandler::signalBit(sig))
+            {
+                sigdelset(&blockset, sig);
+            }
         }
     }
 
-    // Block the collected signal set for the current thread
+    // Block the precomputed signal set for the current thread
     if (pthread_sigmask(SIG_BLOCK, &blockset, nullptr) != 0)
     {
 #ifdef DEBUG_SIGNAL_HANDLER
@@ -131,14 +239,14 @@ void block_signals()
  *
  * @details
  * Initializes the internal state flags, saves terminal settings,
- * modifies terminal behavior if applicable, constructs the signal set from
- * `signal_map`, and blocks those signals for the current thread. These blocked
+ * modifies terminal behavior if applicable, takes the signal set from
+ * `signal_table`, and blocks those signals for the current thread. These blocked
  * signals will typically be handled by a dedicated thread.
  *
  * Key behaviors:
  * - Saves the current terminal settings (if possible).
  * - Disables ECHOCTL (so ^C is not echoed as `^C`) if supported.
- * - Constructs a `sigset_t` from `signal_map` entries.
+ * - Copies the precomputed `sigset_t` of handled signals.
  * - Blocks the signals so they are not delivered to this or future threads
  *   unless explicitly unblocked.
  *
@@ -151,147 +259,1986 @@ void block_signals()
  * If `pthread_sigmask()` fails, signals may not be properly blocked.
  */
 SignalHandler::SignalHandler()
-    : running(false),
+    : worker_thread(),
+      worker_started(false),
+      options_applied(true),
+      running(false),
       stop_requested(false),
       stopping(false),
-      termios_saved(false)
+      pool_cursor(0),
+      active_mask(handled_mask),
+      waiters(nullptr),
+      rcu_reader(-1),
+      dispatch_tid(0),
+      watchdog_interval_ms(0),
+      profile_window(0),
+      profile_hz(0),
+      registry_slot(-1),
+      preblocked_mask(0),
+      inbox_pending(false),
+      signal_fd(-1),
+      fork_mode(ForkMode::Keep),
+      terminal_mode(TerminalMode::Auto),
+      shard_mask(0)
 {
+    for (auto &slot : handler_slots)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto &policy : dispatch_policies)
+    {
+        policy.store(static_cast<std::uint8_t>(DispatchPolicy::Inline), std::memory_order_relaxed);
+    }
+    pool_readers.fill(-1);
 }
 
 /**
- * @brief Starts the signal handling worker thread.
+ * @brief Subscribes to the registry with the wait set.
  *
  * @details
- * Launches a new thread that runs the `SignalHandler::run()` method.
- * This thread is responsible for synchronously waiting on the signal set
- * defined in the constructor and responding accordingly.
+ * Common setup for both the threaded and the signalfd modes:
+ * - Builds `signal_set` from the handled and registered signals.
+ * - Subscribes to `SignalRegistry`, which blocks `signal_set` for the
+ *   calling thread.
+ * - Unless deferred, applies the terminal mode, which saves the terminal
+ *   settings (disabling ECHOCTL) if this is the first instance to do so.
  *
- * @note
- * This method should only be called once per instance. Calling it multiple
- * times without joining the previous thread may lead to undefined behavior.
+ * @param defer_terminal Leave the terminal to the signal thread.
+ * @return `true` if the handler is ready to wait, `false` if the registry
+ *         has no free slot.
  */
-void SignalHandler::start()
+bool SignalHandler::prepare(bool defer_terminal)
 {
-    running.store(true);
+    std::lock_guard<std::mutex> lock(registry_mutex);
 
-    // Save current terminal settings for STDIN (file descriptor 0)
-    if (tcgetattr(STDIN_FILENO, &original_termios) == 0)
+    // An explicit setGraceBudget() wins over the environment
+    if (!SignalGrace::configured())
     {
-        termios_saved = true;
-
-        // Make a copy and update it to disable ECHOCTL if available
-        termios new_termios = original_termios;
-#ifdef ECHOCTL
-        new_termios.c_lflag &= ~ECHOCTL; // Don't echo control characters
-#endif
-        tcsetattr(STDIN_FILENO, TCSANOW, &new_termios); // Apply changes immediately
+        SignalGrace::configureFromEnv();
     }
 
-    // Initialize the signal set with all signals defined in signal_map
-    if (sigemptyset(&signal_set) != 0)
+    // Handled signals plus any registered before start
+    std::uint64_t mask = waitMask();
+    maskToSet(mask, signal_set);
+
+    registry_slot = SignalRegistry::instance().subscribe(this, mask, preblocked_mask);
+    preblocked_mask = 0;
+    if (registry_slot < 0)
     {
 #ifdef DEBUG_SIGNAL_HANDLER
-        perror("sigemptyset");
+        std::cerr << "SignalRegistry is full." << std::endl;
 #endif
+        return false;
+    }
+
+    if (!defer_terminal)
+    {
+        applyTerminalMode();
+    }
+    return true;
+}
+
+/**
+ * @brief Takes a terminal reference according to `terminal_mode`.
+ *
+ * @details `isatty()` and `tcgetpgrp()` are one ioctl each and fail fast
+ * on /dev/null, pipes and sockets. A background process is skipped too,
+ * since changing the terminal from there raises SIGTTOU.
+ */
+void SignalHandler::applyTerminalMode()
+{
+    if (terminal_mode == TerminalMode::Skip)
+    {
+        return;
+    }
+
+    if (terminal_mode != TerminalMode::Sync &&
+        (!isatty(STDIN_FILENO) || tcgetpgrp(STDIN_FILENO) != getpgrp()))
+    {
         return;
     }
 
-    for (const auto &entry : signal_map)
+    SignalRegistry::instance().acquireTerminal(registry_slot);
+}
+
+/**
+ * @brief Leaves the registry once nothing dispatches any more.
+ *
+ * @details The last instance to leave restores the signal mask and the
+ * terminal. Forwarded signals still queued are discarded.
+ */
+void SignalHandler::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        SignalRegistry::instance().unsubscribe(registry_slot);
+        registry_slot = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(inbox_mutex);
+    inbox.clear();
+    inbox_pending.store(false);
+
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> shard_lock(shard->inbox_mutex);
+        shard->inbox.clear();
+        shard->inbox_pending.store(false);
+    }
+}
+
+/**
+ * @brief Queues a signal received by another instance.
+ *
+ * @details Runs on the receiving instance's dispatching thread. The record
+ * is appended to the inbox and this instance's dispatching thread woken
+ * with the private wake-up signal, directed at that thread alone. A
+ * signal one of our shards owns goes to that shard's inbox and thread
+ * instead, so its handler and throttle slot stay on one thread.
+ *
+ * @param info The signal.
+ */
+void SignalHandler::forward(const siginfo_t &info)
+{
+    // A sharded signal is only ever dispatched by its own shard
+    std::uint64_t bit = signalBit(info.si_signo);
+    if (bit & shard_mask)
     {
-        if (sigaddset(&signal_set, entry.first) != 0)
+        for (auto &shard : shards)
         {
-#ifdef DEBUG_SIGNAL_HANDLER
-            perror("sigaddset");
-#endif
-            // Continue adding the remaining signals
+            if ((shard->mask & bit) == 0)
+                continue;
+
+            {
+                std::lock_guard<std::mutex> lock(shard->inbox_mutex);
+                shard->inbox.push_back(info);
+            }
+            shard->inbox_pending.store(true, std::memory_order_release);
+            wakeShards(bit);
+            return;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        inbox.push_back(info);
+    }
+    inbox_pending.store(true, std::memory_order_release);
+
+    if (signal_fd >= 0)
+    {
+        // Readable only in the thread that reads the signalfd
+        syscall(SYS_tgkill, getpid(), dispatch_tid, wakeSignal());
+    }
+    else
+    {
+        wake();
+    }
+}
+
+/**
+ * @brief Dispatches signals forwarded by other instances.
+ *
+ * @return The number of signals dispatched.
+ */
+std::size_t SignalHandler::drainInbox(Shard *shard)
+{
+    std::atomic<bool> &pending_flag = shard != nullptr ? shard->inbox_pending : inbox_pending;
+    if (!pending_flag.exchange(false, std::memory_order_acquire))
+    {
+        return 0;
+    }
+
+    std::vector<siginfo_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(shard != nullptr ? shard->inbox_mutex : inbox_mutex);
+        pending.swap(shard != nullptr ? shard->inbox : inbox);
+    }
+
+    if (pending.empty())
+    {
+        return 0;
+    }
+    return dispatchBatch(pending.data(), pending.size(), SignalMetrics::now(), true, shard);
+}
+
+/**
+ * @brief Recovers the handler in a forked child.
+ *
+ * @details
+ * Runs in the child's only thread, from `SignalRegistry`'s atfork handler.
+ * Whatever the mode, the state tied to threads that did not survive is
+ * reset first: locks are re-initialized, forwarded signals dropped, the
+ * lost threads' RCU slots freed and the pool's workers forgotten, so a
+ * later `stop()` in the child returns instead of joining a ghost. Then:
+ * - `Keep`: nothing more; the signals stay blocked.
+ * - `Respawn`: the signals are blocked in this thread and a new signal
+ *   thread started, with new shard threads, or a fresh signalfd placed at
+ *   the old descriptor number, which the child's event loop may not have
+ *   registered yet.
+ * - `Detach`: `stop()`, which unblocks the signals but, with the terminal
+ *   shared with the parent, leaves the terminal alone.
+ */
+void SignalHandler::afterFork()
+{
+    // Threads that held these at the fork are gone and cannot unlock them
+    new (&registry_mutex) std::mutex();
+    new (&update_mutex) std::mutex();
+    new (&inbox_mutex) std::mutex();
+    new (&waiters_mutex) std::mutex();
+    inbox.clear();
+    inbox_pending.store(false);
+    thread_watchdog.afterFork();
+    sampling_profiler.afterFork();
+    signal_throttle.afterFork();
+    SignalGrace::afterFork();
+
+    ForkMode mode = fork_mode.load();
+    bool respawn = mode == ForkMode::Respawn;
+    shardsAfterFork(respawn && running.load() && !stop_requested.load());
+
+    // The signal thread forked from a handler and carries on in the child
+    if (worker_started.load() && pthread_equal(worker_thread, pthread_self()))
+    {
+        dispatch_tid = static_cast<int>(syscall(SYS_gettid));
+        armWatchdog();
+        return;
+    }
+
+    if (dispatch_pool.running())
+    {
+        for (int &reader : pool_readers)
+        {
+            if (reader >= 0)
+            {
+                rcu.unregisterReader(reader);
+                reader = respawn ? rcu.registerReader() : -1;
+            }
         }
+        dispatch_pool.afterFork(respawn);
+    }
+
+    if (signal_fd < 0)
+    {
+        worker_started.store(false);
+        rcu.unregisterReader(rcu_reader);
+        rcu_reader = -1;
+    }
+    else if (!SignalRcu::inReadSection())
+    {
+        // Whoever calls dispatchPending() in the child is this thread
+        rcu.unregisterReader(rcu_reader);
+        rcu_reader = rcu.registerReader();
+        dispatch_tid = static_cast<int>(syscall(SYS_gettid));
+    }
+
+    if (!running.load() || stop_requested.load())
+    {
+        return;
+    }
+
+    if (mode == ForkMode::Detach)
+    {
+        stop();
+        return;
     }
 
-    // Block the assembled signal set for the current thread
-    if (pthread_sigmask(SIG_BLOCK, &signal_set, nullptr) != 0)
+    if (!respawn)
     {
+        return;
+    }
+
+    sigset_t wait_set;
+    maskToSet(waitMask(), wait_set);
+    pthread_sigmask(SIG_BLOCK, &wait_set, nullptr);
+
+    if (signal_fd >= 0)
+    {
+        sigaddset(&wait_set, wakeSignal());
+        int fresh = signalfd(-1, &wait_set, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (fresh < 0 || dup3(fresh, signal_fd, O_CLOEXEC) < 0)
+        {
 #ifdef DEBUG_SIGNAL_HANDLER
-        perror("pthread_sigmask");
+            perror("signalfd");
 #endif
+        }
+        if (fresh >= 0)
+        {
+            close(fresh);
+        }
+        armWatchdog();
+    }
+    else if (!spawnWorker())
+    {
+        running.store(false);
     }
-
-    // Start the signal handling thread explicitly
-    worker_thread = std::thread(&SignalHandler::run, this);
 }
 
 /**
- * @brief Destructor for the SignalHandler class.
+ * @brief Starts the signal handling worker thread.
  *
  * @details
- * Ensures proper shutdown of the signal handling thread if the handler is still running.
- * If `running` is false, the thread has already been stopped and nothing is done.
- * Otherwise, `stop()` is called to clean up the worker thread and restore terminal state
- * if necessary.
+ * Launches a new thread that runs the `SignalHandler::run()` method.
+ * This thread is responsible for synchronously waiting on the signal set
+ * defined in the constructor and responding accordingly.
  *
  * @note
- * Thread-safe since `running` is checked atomically.
- *
- * @warning
- * If `stop()` is not idempotent, calling it from the destructor could cause side effects
- * if it was already called manually.
+ * This method should only be called once per instance. Calling it multiple
+ * times without joining the previous thread may lead to undefined behavior.
  */
-SignalHandler::~SignalHandler()
+void SignalHandler::start()
 {
-    if (!running.load())
+    running.store(true);
+
+    if (!prepare(terminal_mode == TerminalMode::Async))
     {
-        // Already stopped — nothing to do
+        running.store(false);
         return;
     }
 
-    // Gracefully stop the signal handling thread and perform cleanup
-    stop();
+    if (!spawnWorker())
+    {
+        // stop() would return early; give back the slot, mask and terminal here
+        release();
+        running.store(false);
+        return;
+    }
+
+    for (auto &shard : shards)
+    {
+        if (!spawnShard(*shard))
+        {
+            // Half the signals would go unanswered; take the rest down too
+            stop();
+            return;
+        }
+    }
 }
 
 /**
- * @brief Sets the user-defined callback for signal handling.
+ * @brief Creates the signal thread.
  *
- * @details
- * Registers a callback function to be invoked when a signal is received and
- * processed by the signal handling thread.
+ * @details The thread starts with every signal blocked and the attributes
+ * from `setThreadOptions()` applied.
  *
- * The callback function must accept two arguments:
- * - `int signal_number`: The signal that was received.
- * - `bool fatal`: Indicates whether the signal is considered fatal according
- *   to the signal map.
+ * @return `true` if the thread was created.
+ */
+bool SignalHandler::spawnWorker()
+{
+    if (!spawnThread(worker_thread, thread_options, &SignalHandler::threadMain, this))
+    {
+        return false;
+    }
+
+    worker_started.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Creates a thread for the signal loop.
  *
- * @param cb The callback function to assign.
+ * @details Shared by the main signal thread and the shards. The new
+ * thread inherits a mask with every signal blocked, so signals registered
+ * later, and the wake-up signal, are only ever taken by the `sigwaitinfo()`
+ * of the thread that waits on them.
+ *
+ * @param thread Receives the thread.
+ * @param options Placement, policy and stack size.
+ * @param entry The thread's entry point.
+ * @param arg Argument for `entry`.
+ * @return `true` if the thread was created.
+ */
+bool SignalHandler::spawnThread(pthread_t &thread, const ThreadOptions &options,
+                                void *(*entry)(void *), void *arg)
+{
+    sigset_t all, previous;
+    sigfillset(&all);
+    if (SignalCrashHandler::installed())
+    {
+        // ...except faults, which must reach the crash path in this thread too
+        for (int sig = 1; sig < signal_limit; ++sig)
+        {
+            if (SignalCrashHandler::fault_mask & signalBit(sig))
+            {
+                sigdelset(&all, sig);
+            }
+        }
+    }
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+
+    // Claim the wake-up signal before anything can call wake()
+    wakeSignal();
+
+    // Placement and stack come from the attributes, before the thread runs
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (options.stack_size > 0)
+    {
+        std::size_t size = options.stack_size;
+        if (size < static_cast<std::size_t>(PTHREAD_STACK_MIN))
+        {
+            size = PTHREAD_STACK_MIN;
+        }
+        pthread_attr_setstacksize(&attr, size);
+    }
+    if (options.pin)
+    {
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &options.affinity);
+    }
+    if (options.policy >= 0)
+    {
+        sched_param param;
+        param.sched_priority = options.priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, options.policy);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+
+    int ret = pthread_create(&thread, &attr, entry, arg);
+    if (ret == EPERM && options.policy >= 0)
+    {
+        // Not allowed to set the policy; start anyway and report it
+        options_applied.store(false);
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        ret = pthread_create(&thread, &attr, entry, arg);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (ret != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        errno = ret;
+        perror("pthread_create");
+#endif
+    }
+
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    return ret == 0;
+}
+
+/**
+ * @brief Names the calling thread.
+ *
+ * @param name The name; empty leaves the inherited one.
+ * @return `false` if the name could not be set.
+ */
+static bool nameThread(const std::string &name)
+{
+    if (name.empty())
+    {
+        return true;
+    }
+
+    // The kernel limit is 16 bytes including the terminator
+    std::string truncated = name.substr(0, 15);
+    return pthread_setname_np(pthread_self(), truncated.c_str()) == 0;
+}
+
+/**
+ * @brief Entry point of the signal thread.
+ *
+ * @details Applies the thread name before entering `run()`, so profilers
+ * and `top -H` show it from the first sample.
+ *
+ * @param self The SignalHandler that created the thread.
+ * @return Always nullptr.
+ */
+void *SignalHandler::threadMain(void *self)
+{
+    auto *handler = static_cast<SignalHandler *>(self);
+
+    if (!nameThread(handler->thread_options.name))
+    {
+        handler->options_applied.store(false);
+    }
+
+    handler->run();
+    return nullptr;
+}
+
+/**
+ * @brief Sets the attributes for the signal thread.
+ *
+ * @param options The attributes to use at the next `start()`.
+ * @return `true` if recorded, `false` if already running.
+ */
+bool SignalHandler::setThreadOptions(const ThreadOptions &options)
+{
+    if (running.load())
+    {
+        return false;
+    }
+
+    thread_options = options;
+    return true;
+}
+
+/**
+ * @brief Restricts the signal thread to a set of CPUs.
+ *
+ * @details
+ * Before `start()` the set is stored in the thread options and applied
+ * through the creation attributes; afterwards `pthread_setaffinity_np()`
+ * moves the running thread.
+ *
+ * @param cpus The allowed CPUs.
+ * @return `true` if recorded or applied.
+ */
+bool SignalHandler::setAffinity(const cpu_set_t &cpus)
+{
+    if (!worker_started.load(std::memory_order_acquire))
+    {
+        if (running.load())
+        {
+            return false; // signalfd mode has no thread to pin
+        }
+
+        thread_options.pin = true;
+        thread_options.affinity = cpus;
+        return true;
+    }
+
+    return pthread_setaffinity_np(worker_thread, sizeof(cpu_set_t), &cpus) == 0;
+}
+
+/**
+ * @brief Reports whether every requested thread option was applied.
+ *
+ * @return `false` if the policy or name could not be set.
+ */
+bool SignalHandler::threadOptionsApplied() const
+{
+    return options_applied.load();
+}
+
+/**
+ * @brief Adds a shard that owns a subset of the signals.
+ *
+ * @details
+ * Handled signals stay with the main thread, which runs the stop path,
+ * the callbacks and the pool. The wake-up signal is every thread's own
+ * and faults belong to the faulting thread. The signals are added to no
+ * wait set here; they are waited on once registered, like any other.
+ *
+ * @param signals Signals the shard owns.
+ * @param options Attributes for the shard thread.
+ * @return The shard index, or -1 on failure.
+ */
+int SignalHandler::addShard(const sigset_t &signals, const ThreadOptions &options)
+{
+    if (running.load() || shards.size() >= max_shards)
+    {
+        return -1;
+    }
+
+    std::uint64_t mask = 0;
+    for (int sig = 1; sig < signal_limit; ++sig)
+    {
+        if (sigismember(&signals, sig) != 1)
+        {
+            continue;
+        }
+
+        if (sig == SIGKILL || sig == SIGSTOP || sig == wakeSignal() || isHandled(sig) ||
+            (SignalCrashHandler::fault_mask & signalBit(sig)) != 0)
+        {
+            return -1;
+        }
+        mask |= signalBit(sig);
+    }
+
+    if (mask == 0 || (mask & shard_mask) != 0)
+    {
+        return -1;
+    }
+
+    auto shard = std::make_unique<Shard>();
+    shard->owner = this;
+    shard->mask = mask;
+    shard->options = options;
+    shards.push_back(std::move(shard));
+    shard_mask |= mask;
+    return static_cast<int>(shards.size() - 1);
+}
+
+/**
+ * @brief Adds a shard pinned to a single CPU.
+ *
+ * @param signals Signals the shard owns.
+ * @param cpu The CPU for the shard thread.
+ * @return The shard index, or -1 on failure.
+ */
+int SignalHandler::addShard(const sigset_t &signals, int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        return -1;
+    }
+
+    ThreadOptions options;
+    options.pin = true;
+    CPU_ZERO(&options.affinity);
+    CPU_SET(cpu, &options.affinity);
+    return addShard(signals, options);
+}
+
+/**
+ * @brief Returns the number of shards.
+ *
+ * @return The shard count.
+ */
+std::size_t SignalHandler::shardCount() const
+{
+    return shards.size();
+}
+
+/**
+ * @brief Returns a shard's event ring.
+ *
+ * @param index The shard index.
+ * @return The ring, or the main ring if `index` is out of range.
+ */
+const SignalEventRing &SignalHandler::shardEvents(std::size_t index) const
+{
+    if (index >= shards.size())
+    {
+        return event_ring;
+    }
+    return shards[index]->events;
+}
+
+/**
+ * @brief Creates a shard's thread.
+ *
+ * @param shard The shard.
+ * @return `true` if the thread was created.
+ */
+bool SignalHandler::spawnShard(Shard &shard)
+{
+    if (!spawnThread(shard.thread, shard.options, &SignalHandler::shardMain, &shard))
+    {
+        return false;
+    }
+
+    shard.started.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Wakes the shard threads that own any of the given signals.
+ *
+ * @details Sent to each thread alone, like `wake()`, so the thread
+ * rebuilds its wait set or sees the stop request.
+ *
+ * @param bits Signals in `signalBit()` layout.
+ */
+void SignalHandler::wakeShards(std::uint64_t bits)
+{
+    for (auto &shard : shards)
+    {
+        if ((shard->mask & bits) != 0 && shard->started.load(std::memory_order_acquire))
+        {
+            pthread_kill(shard->thread, wakeSignal());
+        }
+    }
+}
+
+/**
+ * @brief Wakes and joins every shard thread.
+ *
+ * @note Called from `stop()` after `stop_requested` is set.
+ */
+void SignalHandler::joinShards()
+{
+    wakeShards(~std::uint64_t{0});
+    for (auto &shard : shards)
+    {
+        if (shard->started.exchange(false, std::memory_order_acq_rel))
+        {
+            pthread_join(shard->thread, nullptr);
+        }
+    }
+}
+
+/**
+ * @brief Recovers the shards in a forked child.
+ *
+ * @details Only the forking thread survives. If that was a shard thread
+ * it carries on with a new thread id; every other shard's RCU slot is
+ * freed and its thread forgotten, then started afresh if asked.
+ *
+ * @param respawn Start new threads for the lost shards.
+ */
+void SignalHandler::shardsAfterFork(bool respawn)
+{
+    for (auto &shard : shards)
+    {
+        if (shard->started.load() && pthread_equal(shard->thread, pthread_self()))
+        {
+            shard->tid = static_cast<int>(syscall(SYS_gettid));
+            continue;
+        }
+
+        shard->started.store(false);
+        rcu.unregisterReader(shard->reader);
+        shard->reader = -1;
+
+        // Whoever held this at the fork is gone
+        new (&shard->inbox_mutex) std::mutex();
+        shard->inbox.clear();
+        shard->inbox_pending.store(false);
+
+        if (respawn && !spawnShard(*shard))
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            std::cerr << "Shard thread not respawned." << std::endl;
+#endif
+        }
+    }
+}
+
+/**
+ * @brief Prepares signal handling for a caller-owned event loop.
+ *
+ * @details
+ * Performs the same setup as `start()` but, instead of spawning a thread,
+ * creates a non-blocking, close-on-exec `signalfd` over `signal_set`. The
+ * descriptor becomes readable whenever one of the handled signals is
+ * pending, and the caller is expected to invoke `dispatchPending()` from
+ * its own epoll/io_uring loop at that point.
+ *
+ * Because no thread is created, `stop()` does not need a wake-up signal and
+ * `setPriority()` has no effect in this mode.
+ *
+ * @return The signalfd descriptor, or -1 on failure, if already started or
+ *         if shards were added.
+ *
+ * @note
+ * As with `start()`, the handled signals must be blocked in every thread
+ * (see `block_signals()`) or they may be delivered elsewhere.
+ */
+int SignalHandler::startSignalFd()
+{
+    // Shards need threads of their own
+    if (running.load() || !shards.empty())
+    {
+        return -1;
+    }
+
+    // No thread to defer to; Async behaves like Auto
+    if (!prepare(false))
+    {
+        return -1;
+    }
+
+    // Forwarded signals arrive as a wake-up directed at this thread
+    sigset_t wake_set;
+    sigemptyset(&wake_set);
+    sigaddset(&wake_set, wakeSignal());
+    pthread_sigmask(SIG_BLOCK, &wake_set, nullptr);
+    sigaddset(&signal_set, wakeSignal());
+
+    signal_fd = signalfd(-1, &signal_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("signalfd");
+#endif
+        release();
+        return -1;
+    }
+
+    // The thread calling dispatchPending() is the RCU reader in this mode
+    rcu_reader = rcu.registerReader();
+    dispatch_tid = static_cast<int>(syscall(SYS_gettid));
+    armWatchdog();
+
+    running.store(true);
+    return signal_fd;
+}
+
+/**
+ * @brief Returns the descriptor created by `startSignalFd()`.
+ *
+ * @return The signalfd descriptor, or -1 if not in signalfd mode.
+ */
+int SignalHandler::getSignalFd() const
+{
+    return signal_fd;
+}
+
+/**
+ * @brief Drains the signalfd and dispatches every queued signal.
+ *
+ * @details
+ * Reads `signalfd_siginfo` records until the descriptor reports `EAGAIN`
+ * and routes each one through the same dispatch path used by `run()`.
+ * Safe to call spuriously; it returns 0 if nothing is pending.
+ *
+ * @return The number of signals dispatched, or -1 if not in signalfd mode.
+ */
+int SignalHandler::dispatchPending()
+{
+    if (signal_fd < 0 || rcu_reader < 0)
+    {
+        return -1;
+    }
+
+    int dispatched = 0;
+    signalfd_siginfo fdsi[batch_capacity];
+    siginfo_t records[batch_capacity];
+
+    while (true)
+    {
+        // One read drains as many queued records as fit in the buffer
+        ssize_t n = read(signal_fd, fdsi, sizeof(fdsi));
+        if (n < static_cast<ssize_t>(sizeof(signalfd_siginfo)))
+        {
+            // EAGAIN means the queue is drained; anything else is unexpected
+#ifdef DEBUG_SIGNAL_HANDLER
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+            {
+                perror("read(signalfd)");
+            }
+#endif
+            break;
+        }
+
+        std::int64_t woke_ns = SignalMetrics::now();
+        std::size_t count = static_cast<std::size_t>(n) / sizeof(signalfd_siginfo);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Translate the signalfd record into the siginfo_t callers expect
+            fromSignalFd(fdsi[i], records[i]);
+        }
+
+        // Wake-ups, timer ticks and filtered records are not dispatches
+        dispatched += static_cast<int>(dispatchBatch(records, count, woke_ns));
+
+        if (count < batch_capacity)
+        {
+            break; // Short read, nothing else is queued right now
+        }
+    }
+
+    dispatched += static_cast<int>(drainInbox());
+    return dispatched;
+}
+
+/**
+ * @brief Destructor for the SignalHandler class.
+ *
+ * @details
+ * Ensures proper shutdown of the signal handling thread if the handler is still running.
+ * If `running` is false, the thread has already been stopped and nothing is done.
+ * Otherwise, `stop()` is called to clean up the worker thread and restore terminal state
+ * if necessary.
+ *
+ * @note
+ * Thread-safe since `running` is checked atomically.
+ *
+ * @warning
+ * If `stop()` is not idempotent, calling it from the destructor could cause side effects
+ * if it was already called manually.
+ */
+SignalHandler::~SignalHandler()
+{
+    // The crash path must not append to a log that is about to be unmapped
+    if (SignalCrashHandler::eventLog() == &event_log)
+    {
+        SignalCrashHandler::setEventLog(nullptr);
+    }
+
+    if (!running.load())
+    {
+        // Already stopped — nothing to do
+        return;
+    }
+
+    // Gracefully stop the signal handling thread and perform cleanup
+    stop();
+}
+
+/**
+ * @brief Sets the user-defined callback for signal handling.
+ *
+ * @details
+ * Registers a callback function to be invoked when a signal is received and
+ * processed by the signal handling thread.
+ *
+ * The callback function must accept two arguments:
+ * - `int signal_number`: The signal that was received.
+ * - `bool fatal`: Indicates whether the signal is considered fatal according
+ *   to the signal map.
+ *
+ * @param cb The callback function to assign.
+ *
+ * @note
+ * This method should be called before `start()` to ensure the callback is
+ * available when signals are received.
+ */
+void SignalHandler::setCallback(const Callback &cb)
+{
+    // Store the user-provided signal handler callback
+    callback = cb;
+}
+
+/**
+ * @brief Sets the batch callback for signal handling.
+ *
+ * @details
+ * When a batch callback is registered, every wakeup of the signal thread
+ * drains all other pending handled signals with a zero-timeout
+ * `sigtimedwait()` before dispatching, and the whole burst is passed to the
+ * callback in a single call. In signalfd mode `dispatchPending()` reads up
+ * to `batch_capacity` records per `read()` regardless.
+ *
+ * Standard signals are still coalesced by the kernel; only distinct signals
+ * or queued real-time signals produce separate records.
+ *
+ * @param cb The batch callback function to assign.
+ *
+ * @note
+ * Takes precedence over `setCallback()`. Should be called before `start()`.
+ */
+void SignalHandler::setBatchCallback(const BatchCallback &cb)
+{
+    batch_callback = cb;
+}
+
+/**
+ * @brief Reports whether a signal is marked immediate in `signal_table`.
+ *
+ * @param signum The signal number to check.
+ * @return `true` if the signal is handled and flagged immediate.
+ */
+bool SignalHandler::isImmediate(int signum)
+{
+    return signum > 0 && signum < signal_limit &&
+           signal_table[signum].handled && signal_table[signum].immediate;
+}
+
+/**
+ * @brief Reports whether a signal is marked handled in `signal_table`.
+ *
+ * @param signum The signal number to check.
+ * @return `true` if the signal is blocked and waited on.
+ */
+bool SignalHandler::isHandled(int signum)
+{
+    return signum > 0 && signum < signal_limit && signal_table[signum].handled;
+}
+
+/**
+ * @brief Returns the set of handled signals, built once from `handled_mask`.
+ *
+ * @details
+ * The set is a function-local static, so it is built on first use with
+ * thread-safe initialization rather than during static initialization.
+ * Every caller that previously walked the signal list to build a set now
+ * copies this one.
+ *
+ * @return The precomputed set of handled signals.
+ */
+const sigset_t &SignalHandler::handledSignals()
+{
+    static const sigset_t set = []
+    {
+        sigset_t built;
+        maskToSet(handled_mask, built);
+        return built;
+    }();
+
+    return set;
+}
+
+/**
+ * @brief Installs or replaces the handler for a single signal.
+ *
+ * @details
+ * Each signal has two preallocated slots. The new handler is written into
+ * the slot that is not published, the pointer is swapped atomically, and
+ * the writer then waits for an RCU grace period before releasing the old
+ * slot's handler. The dispatching thread only ever performs an acquire load
+ * of the slot pointer, so it never blocks on registration. The wait holds
+ * only `update_mutex`, never `registry_mutex`, which handlers may take
+ * through `watchSignal()`.
+ *
+ * Signals outside the default table are added to the wait set: the signal
+ * thread is woken to pick up the new set, or the signalfd mask is updated.
+ * The calling thread blocks the signal too, but other threads must already
+ * have it blocked (as with `block_signals()`).
+ *
+ * @param signum The signal number to handle.
+ * @param handler The function to invoke with the signal information.
+ * @param flags Handler options.
+ * @return `true` on success, `false` for invalid or uncatchable signals,
+ *         an empty handler, or a call from inside a dispatching handler.
+ */
+bool SignalHandler::registerHandler(int signum, const Handler &handler, HandlerFlags flags)
+{
+    if (signum <= 0 || signum >= signal_limit || signum == SIGKILL || signum == SIGSTOP ||
+        signum == wakeSignal() || !handler)
+    {
+        return false;
+    }
+
+    // A grace period cannot complete while this thread is itself dispatching
+    if (SignalRcu::inReadSection())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> update(update_mutex);
+
+    HandlerSlot *current = handler_slots[signum].load(std::memory_order_acquire);
+    HandlerSlot *next = (current == &slot_storage[signum][0]) ? &slot_storage[signum][1]
+                                                              : &slot_storage[signum][0];
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+
+        // The unpublished slot is not visible to readers, fill it in place
+        next->handler = handler;
+        next->flags = flags;
+        handler_slots[signum].store(next, std::memory_order_release);
+
+        // Start waiting on the signal if it was not already in the set
+        addToWaitSet(signum);
+    }
+
+    // Release the previous handler once no dispatch can still be using it;
+    // a handler waiting on registry_mutex would never end its read section
+    if (current != nullptr)
+    {
+        rcu.synchronize();
+        current->handler = nullptr;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Adds a signal to the wait set and refreshes the live wait.
+ *
+ * @details
+ * Only the first call for a signal does any work. While running, the
+ * registry takes a reference on the signal (blocking it in the calling
+ * thread if it is new to the process), then either the signalfd mask is
+ * updated or the signal thread is woken to rebuild its set. Before
+ * `start()` the signal is blocked in the calling thread right away, so it
+ * cannot take its default action in the meantime, and handed to the
+ * registry at `start()` to be unblocked with the rest.
+ *
+ * @param signum The signal number.
+ */
+void SignalHandler::addToWaitSet(int signum)
+{
+    std::uint64_t bit = signalBit(signum);
+    if ((active_mask.fetch_or(bit, std::memory_order_acq_rel) & bit) != 0)
+    {
+        return;
+    }
+
+    if (registry_slot < 0)
+    {
+        SignalRegistry::instance().saveOriginalMask();
+
+        sigset_t one;
+        sigset_t previous;
+        sigemptyset(&one);
+        sigaddset(&one, signum);
+        pthread_sigmask(SIG_BLOCK, &one, &previous);
+        if (sigismember(&previous, signum) != 1)
+        {
+            preblocked_mask |= bit;
+        }
+        return;
+    }
+
+    SignalRegistry::instance().extend(registry_slot, waitMask());
+
+    if (signal_fd >= 0)
+    {
+        sigset_t updated;
+        maskToSet(waitMask(), updated);
+        sigaddset(&updated, wakeSignal());
+        signalfd(signal_fd, &updated, 0);
+    }
+    else if (bit & shard_mask)
+    {
+        wakeShards(bit);
+    }
+    else
+    {
+        wake();
+    }
+}
+
+/**
+ * @brief Adds a signal to the wait set with no handler.
+ *
+ * @details
+ * Unlike `registerHandler()` this needs no grace period, so it may be
+ * called from a handler or a resumed coroutine on the signal thread.
+ *
+ * @param signum The signal number.
+ * @return `true` on success.
+ */
+bool SignalHandler::watchSignal(int signum)
+{
+    if (signum <= 0 || signum >= signal_limit || signum == SIGKILL || signum == SIGSTOP ||
+        signum == wakeSignal())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    addToWaitSet(signum);
+    return true;
+}
+
+/**
+ * @brief Queues a waiter for the next matching signal.
+ *
+ * @details
+ * Pushes onto a Treiber stack with one compare-exchange. If the handler
+ * stopped while the push was in flight, the queue is drained again so the
+ * waiter is cancelled rather than stranded.
+ *
+ * @param waiter The waiter to queue.
+ * @return `true` if queued; `false` if the handler is not running.
+ */
+bool SignalHandler::addWaiter(SignalWaiter &waiter)
+{
+    if (!running.load() || waiter.complete == nullptr)
+    {
+        return false;
+    }
+
+    pushWaiters(&waiter, &waiter);
+
+    if (!running.load())
+    {
+        cancelWaiters();
+    }
+    return true;
+}
+
+/**
+ * @brief Pushes a chain of waiters onto the lock-free stack.
+ *
+ * @param first Head of the chain.
+ * @param last Tail of the chain, whose link is overwritten.
+ */
+void SignalHandler::pushWaiters(SignalWaiter *first, SignalWaiter *last)
+{
+    SignalWaiter *head = waiters.load(std::memory_order_relaxed);
+    do
+    {
+        last->next = head;
+    } while (!waiters.compare_exchange_weak(head, first, std::memory_order_release,
+                                            std::memory_order_relaxed));
+}
+
+/**
+ * @brief Completes the waiters matching a signal.
+ *
+ * @details
+ * Detaches the whole stack with one exchange, puts the non-matching
+ * waiters back, and only then runs the completions. A completion that
+ * queues a new waiter therefore waits for the next signal rather than
+ * seeing this one again. The detach and put-back run under
+ * `waiters_mutex`, since shard threads complete waiters too; the
+ * completions run after it is released.
+ *
+ * @param info The dispatched signal.
+ * @return `true` if any waiter was completed.
+ */
+bool SignalHandler::completeWaiters(const siginfo_t &info)
+{
+    std::uint64_t bit = signalBit(info.si_signo);
+    SignalWaiter *fired = nullptr;
+    SignalWaiter *keep_first = nullptr;
+    SignalWaiter *keep_last = nullptr;
+
+    // Another dispatching thread must not see the stack while it is detached
+    std::unique_lock<std::mutex> lock(waiters_mutex);
+    SignalWaiter *list = waiters.exchange(nullptr, std::memory_order_acquire);
+    if (list == nullptr)
+    {
+        return false;
+    }
+
+    while (list != nullptr)
+    {
+        SignalWaiter *w = list;
+        list = list->next;
+
+        if (w->mask & bit)
+        {
+            w->next = fired;
+            fired = w;
+        }
+        else
+        {
+            w->next = keep_first;
+            keep_first = w;
+            if (keep_last == nullptr)
+                keep_last = w;
+        }
+    }
+
+    if (keep_first != nullptr)
+    {
+        pushWaiters(keep_first, keep_last);
+    }
+    lock.unlock();
+
+    bool any = fired != nullptr;
+    while (fired != nullptr)
+    {
+        SignalWaiter *w = fired;
+        fired = fired->next; // Read before completion may reuse the node
+        w->info = info;
+        w->complete(w);
+    }
+    return any;
+}
+
+/**
+ * @brief Cancels every queued waiter.
+ *
+ * @details Each is completed with a zeroed `siginfo_t`, so an awaiting
+ * coroutine resumes and sees `si_signo == 0` instead of hanging.
+ */
+void SignalHandler::cancelWaiters()
+{
+    SignalWaiter *list = waiters.exchange(nullptr, std::memory_order_acquire);
+    while (list != nullptr)
+    {
+        SignalWaiter *w = list;
+        list = list->next;
+        std::memset(&w->info, 0, sizeof(w->info));
+        w->complete(w);
+    }
+}
+
+/**
+ * @brief Starts the dispatch pool.
+ *
+ * @details Each worker gets its own RCU reader slot, so `registerHandler()`
+ * waits for a handler running on a worker just as it does for the signal
+ * thread.
+ *
+ * @param threads Number of workers.
+ * @param queue_capacity Jobs per worker queue.
+ * @return `true` if the pool started.
+ */
+bool SignalHandler::enableDispatchPool(std::size_t threads, std::size_t queue_capacity)
+{
+    if (running.load() || dispatch_pool.running() || threads == 0 ||
+        threads > SignalDispatchPool::max_workers)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        pool_readers[i] = rcu.registerReader();
+        if (pool_readers[i] < 0)
+        {
+            stopPool();
+            return false;
+        }
+    }
+
+    if (!dispatch_pool.start(threads, queue_capacity, &SignalHandler::runDeferred, this))
+    {
+        stopPool();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Drains and joins the pool and frees its RCU slots.
+ */
+void SignalHandler::stopPool()
+{
+    dispatch_pool.stop();
+    for (int &reader : pool_readers)
+    {
+        if (reader >= 0)
+        {
+            rcu.unregisterReader(reader);
+            reader = -1;
+        }
+    }
+}
+
+/**
+ * @brief Chooses where a signal's handler or callback runs.
+ *
+ * @param signum The signal number.
+ * @param policy The policy.
+ * @return `true` if set.
+ */
+bool SignalHandler::setDispatchPolicy(int signum, DispatchPolicy policy)
+{
+    if (signum <= 0 || signum >= signal_limit)
+    {
+        return false;
+    }
+
+    dispatch_policies[signum].store(static_cast<std::uint8_t>(policy), std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Sets a signal's throttle policy.
+ *
+ * @details Immediate signals and the wake-up signal are never throttled:
+ * the first must not wait and the second carries the release ticks.
+ *
+ * @param signum The signal number.
+ * @param policy The policy.
+ * @return `true` if stored.
+ */
+bool SignalHandler::setThrottle(int signum, const SignalThrottle::Policy &policy)
+{
+    if (signum <= 0 || signum >= signal_limit || signum == wakeSignal() || isImmediate(signum))
+    {
+        return false;
+    }
+
+    return signal_throttle.set(signum, policy);
+}
+
+/**
+ * @brief Queues a delivery on the pool.
+ *
+ * @details
+ * `Serialized` always uses the signal's own worker (signal number modulo
+ * the pool size), so its deliveries run one at a time and in order.
+ * `Pooled` goes round-robin and tries each worker once before giving up.
+ *
+ * @param info The signal.
+ * @param woke_ns When the dispatching thread woke.
+ * @return `true` if queued.
+ */
+bool SignalHandler::deferDelivery(const siginfo_t &info, std::int64_t woke_ns)
+{
+    auto policy = static_cast<DispatchPolicy>(
+        dispatch_policies[info.si_signo].load(std::memory_order_relaxed));
+    std::size_t workers = dispatch_pool.size();
+    if (policy == DispatchPolicy::Inline || workers == 0)
+    {
+        return false;
+    }
+
+    if (policy == DispatchPolicy::Serialized)
+    {
+        return dispatch_pool.submit(static_cast<std::size_t>(info.si_signo) % workers, info, woke_ns);
+    }
+
+    for (std::size_t tries = 0; tries < workers; ++tries)
+    {
+        std::size_t worker = pool_cursor++ % workers;
+        if (dispatch_pool.submit(worker, info, woke_ns))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs a queued delivery on a pool worker.
+ *
+ * @details The handler is looked up again at run time, inside the
+ * worker's own read-side section. A delivery whose handler was removed in
+ * the meantime falls back to the table behavior, as it would inline.
+ *
+ * @param self The SignalHandler.
+ * @param worker The worker index.
+ * @param job The delivery.
+ */
+void SignalHandler::runDeferred(void *self, std::size_t worker, const SignalDispatchPool::Job &job)
+{
+    auto *handler = static_cast<SignalHandler *>(self);
+    SignalRcu::ReadGuard guard(handler->rcu, handler->pool_readers[worker]);
+
+    int sig = job.info.si_signo;
+    std::int64_t entry_ns = SignalMetrics::now();
+
+    const HandlerSlot *slot = handler->handler_slots[sig].load(std::memory_order_acquire);
+    if (slot != nullptr)
+    {
+        slot->handler(job.info);
+        handler->metrics.onDispatched(sig, job.woke_ns, entry_ns, SignalMetrics::now());
+    }
+    else if (isHandled(sig) && handler->callback)
+    {
+        handler->dispatch(job.info);
+        handler->metrics.onDispatched(sig, job.woke_ns, entry_ns, SignalMetrics::now());
+    }
+}
+
+/**
+ * @brief Removes the handler registered for a signal.
+ *
+ * @details
+ * Unpublishes the slot and waits for an RCU grace period before releasing
+ * the handler. Table signals fall back to the default behavior; other
+ * signals stay in the wait set so they are still consumed, but are ignored.
+ *
+ * @param signum The signal number.
+ * @return `true` if a handler was removed.
+ */
+bool SignalHandler::unregisterHandler(int signum)
+{
+    if (signum <= 0 || signum >= signal_limit || SignalRcu::inReadSection())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> update(update_mutex);
+
+    HandlerSlot *current = handler_slots[signum].exchange(nullptr, std::memory_order_acq_rel);
+    if (current == nullptr)
+    {
+        return false;
+    }
+
+    // Without registry_mutex, so a handler may still call watchSignal()
+    rcu.synchronize();
+    current->handler = nullptr;
+    return true;
+}
+
+/**
+ * @brief Installs a typed handler for a queued real-time signal.
+ *
+ * @details
+ * Wraps the payload handler in a regular per-signal handler that extracts
+ * `si_code`, `si_value`, `si_pid` and `si_uid`. Real-time signals are
+ * queued rather than coalesced, so each `sigqueue()` produces one call.
+ *
+ * @param rtsig A signal in [SIGRTMIN, SIGRTMAX].
+ * @param handler The function to invoke with each payload.
+ * @return `true` on success.
+ */
+bool SignalHandler::registerQueuedHandler(int rtsig, const PayloadHandler &handler)
+{
+    if (!isRealtime(rtsig) || !handler)
+    {
+        return false;
+    }
+
+    return registerHandler(rtsig, [handler](const siginfo_t &info)
+                           {
+                               SignalPayload payload;
+                               payload.signo = info.si_signo;
+                               payload.code = info.si_code;
+                               payload.value = info.si_value;
+                               payload.pid = info.si_pid;
+                               payload.uid = info.si_uid;
+                               handler(payload);
+                           });
+}
+
+/**
+ * @brief Relays a signal to a group of child processes.
+ *
+ * @details With `HandlerFlags::RequestStop` the stop is requested after
+ * the broadcast rather than before it, so a main thread woken by the stop
+ * token finds the round already started when it calls `waitAcks()`.
+ *
+ * @param group The children.
+ * @param signum The signal to relay.
+ * @param flags Handler options for this process.
+ * @return `true` if the handler was installed.
+ */
+bool SignalHandler::bindBroadcast(SignalProcessGroup &group, int signum, HandlerFlags flags)
+{
+    bool stop = flags & HandlerFlags::RequestStop;
+    HandlerFlags own = static_cast<HandlerFlags>(static_cast<unsigned>(flags) &
+                                                 ~static_cast<unsigned>(HandlerFlags::RequestStop));
+
+    return registerHandler(signum, [this, &group, signum, stop](const siginfo_t &)
+                           {
+                               group.broadcast(signum);
+                               if (stop)
+                               {
+                                   onStopSignal();
+                               }
+                           },
+                           own);
+}
+
+/**
+ * @brief Reaps children whenever SIGCHLD arrives.
+ *
+ * @details
+ * SIGCHLD coalesces: one delivery may stand for many exits, so the handler
+ * always drains the whole queue with `SignalChildReaper::reap()` rather
+ * than trusting `si_pid`.
+ *
+ * @return `true` if the handler was installed.
+ */
+bool SignalHandler::enableChildReaping()
+{
+    return registerHandler(SIGCHLD, [this](const siginfo_t &)
+                           { child_reaper.reap(); });
+}
+
+/**
+ * @brief Returns the child reaper.
+ *
+ * @return The reaper.
+ */
+SignalChildReaper &SignalHandler::children()
+{
+    return child_reaper;
+}
+
+/**
+ * @brief Enables stall detection on the dispatching thread.
+ *
+ * @details
+ * Ticks share the wake-up signal. They arrive as SI_TIMER with `si_value`
+ * pointing at the watchdog, so `dispatchBatch()` tells them apart from a
+ * `wake()` and from any real signal, and scans instead of dispatching.
+ *
+ * @param interval Time between scans.
+ * @param handler Called for each new stall.
+ * @param backtraces Capture stalled threads' stacks.
+ * @return `true` if enabled.
+ */
+bool SignalHandler::enableWatchdog(std::chrono::milliseconds interval,
+                                   const SignalWatchdog::StallHandler &handler, bool backtraces)
+{
+    if (running.load() || interval <= std::chrono::milliseconds::zero())
+    {
+        return false;
+    }
+
+    if (backtraces && !thread_watchdog.enableBacktraces())
+    {
+        return false;
+    }
+
+    thread_watchdog.setStallHandler(handler);
+    watchdog_interval_ms.store(interval.count());
+    return true;
+}
+
+/**
+ * @brief Returns the watchdog.
+ *
+ * @return The watchdog.
+ */
+SignalWatchdog &SignalHandler::watchdog()
+{
+    return thread_watchdog;
+}
+
+/**
+ * @brief Starts a profiling window on every `trigger`.
+ *
+ * @details The trigger handler runs on the dispatching thread, so that
+ * thread's ID is where the collection ticks are directed. Like watchdog
+ * ticks they arrive on the wake-up signal and are routed by `si_value`.
+ *
+ * @param path Output file; empty for stderr.
+ * @param window Sampling window.
+ * @param trigger Starts a window.
+ * @param hz Sampling rate.
+ * @return `true` if the trigger was registered.
+ */
+bool SignalHandler::enableProfiler(const std::string &path, std::chrono::milliseconds window,
+                                   int trigger, int hz)
+{
+    if (running.load() || window <= std::chrono::milliseconds::zero() || hz <= 0 ||
+        hz > 1000 || trigger == SIGPROF)
+    {
+        return false;
+    }
+
+    profile_path = path;
+    profile_window = window;
+    profile_hz = hz;
+    return registerHandler(trigger, [this](const siginfo_t &)
+                           {
+        if (!sampling_profiler.begin(profile_window, profile_hz, wakeSignal(), dispatch_tid))
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            std::cerr << "Profiler busy or unavailable." << std::endl;
+#endif
+        } });
+}
+
+/**
+ * @brief Returns the profiler.
+ *
+ * @return The profiler.
+ */
+SignalProfiler &SignalHandler::profiler()
+{
+    return sampling_profiler;
+}
+
+/**
+ * @brief Dumps the process state on every `trigger`.
+ *
+ * @details The dump runs on the dispatching thread, which is captured
+ * directly; every other thread answers the `SignalBacktrace` signal. The
+ * handler is registered without `HandlerFlags::RequestStop`, which is what
+ * turns SIGQUIT from a stop request into a dump request.
+ *
+ * @param path Output file; empty for stderr.
+ * @param trigger Requests a dump.
+ * @return `true` if the trigger was registered.
+ */
+bool SignalHandler::enableStateDump(const std::string &path, int trigger)
+{
+    if (running.load() || !SignalBacktrace::enable())
+    {
+        return false;
+    }
+
+    dump_path = path;
+    return registerHandler(trigger, [this](const siginfo_t &)
+                           {
+        if (!state_dump.writeTo(dump_path, stats()))
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            std::cerr << "State dump failed." << std::endl;
+#endif
+        } });
+}
+
+/**
+ * @brief Returns the state dumper.
+ *
+ * @return The dumper.
+ */
+SignalStateDump &SignalHandler::stateDump()
+{
+    return state_dump;
+}
+
+/**
+ * @brief Writes the running profile window to `profile_path`.
+ *
+ * @details Called on the dispatching thread when the window ends, and on
+ * `stop()` so a window cut short is still written.
+ */
+void SignalHandler::finishProfile()
+{
+    if (!sampling_profiler.active())
+    {
+        return;
+    }
+
+    int fd = STDERR_FILENO;
+    if (!profile_path.empty())
+    {
+        fd = open(profile_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("open");
+#endif
+            fd = STDERR_FILENO;
+        }
+    }
+
+    sampling_profiler.finish(fd);
+
+    if (fd != STDERR_FILENO)
+    {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Arms the watchdog at `dispatch_tid` if it is enabled.
+ */
+void SignalHandler::armWatchdog()
+{
+    std::int64_t interval = watchdog_interval_ms.load();
+    if (interval > 0)
+    {
+        thread_watchdog.arm(wakeSignal(), dispatch_tid, std::chrono::milliseconds(interval));
+    }
+}
+
+/**
+ * @brief Queues a real-time signal with a value.
+ *
+ * @details
+ * A thin wrapper over `sigqueue()` for cheap same-host control messages.
+ * Only real-time signals are accepted, since standard signals coalesce and
+ * would silently drop payloads.
+ *
+ * @param pid The target process.
+ * @param rtsig A signal in [SIGRTMIN, SIGRTMAX].
+ * @param value The payload delivered as `si_value`.
+ * @return `true` if the signal was queued.
+ */
+bool SignalHandler::send(pid_t pid, int rtsig, sigval value)
+{
+    if (!isRealtime(rtsig))
+    {
+        return false;
+    }
+
+    if (sigqueue(pid, rtsig, value) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("sigqueue");
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Queues a real-time signal with an integer command.
+ *
+ * @param pid The target process.
+ * @param rtsig A signal in [SIGRTMIN, SIGRTMAX].
+ * @param value The integer delivered as `si_value.sival_int`.
+ * @return `true` if the signal was queued.
+ */
+bool SignalHandler::send(pid_t pid, int rtsig, int value)
+{
+    sigval v;
+    v.sival_ptr = nullptr; // Clear the full union before setting the int
+    v.sival_int = value;
+    return send(pid, rtsig, v);
+}
+
+/**
+ * @brief Maps an offset from SIGRTMIN to a signal number.
+ *
+ * @details SIGRTMIN is a runtime value (glibc reserves the first few
+ * real-time signals), so real-time signals should always be named this way.
+ *
+ * @param offset Offset from SIGRTMIN.
+ * @return The signal number, or -1 if out of range.
+ */
+int SignalHandler::rtSignal(int offset)
+{
+    if (offset < 0 || offset > SIGRTMAX - SIGRTMIN)
+    {
+        return -1;
+    }
+    return SIGRTMIN + offset;
+}
+
+/**
+ * @brief Returns the signal used internally to wake the signal thread.
+ *
+ * @details Claimed on first use by `claimWakeSignal()`; a function-local
+ * static makes the claim thread-safe and shared by every instance.
+ *
+ * @return The wake-up signal number.
+ */
+int SignalHandler::wakeSignal()
+{
+    static const int claimed = claimWakeSignal();
+    return claimed;
+}
+
+/**
+ * @brief Reports whether a signal is a real-time signal.
+ *
+ * @param signum The signal number to check.
+ * @return `true` if SIGRTMIN <= signum <= SIGRTMAX.
+ */
+bool SignalHandler::isRealtime(int signum)
+{
+    return signum >= SIGRTMIN && signum <= SIGRTMAX;
+}
+
+/**
+ * @brief Returns the broadcast ring of received signals.
+ *
+ * @details
+ * Every handled signal is published to this ring, with its `siginfo_t`
+ * payload, before any callback runs. Consumers poll it with their own
+ * cursor, so workers can learn about signals without sharing a lock with
+ * the signal thread or each other.
+ *
+ * @return The event ring owned by this handler.
+ */
+const SignalEventRing &SignalHandler::events() const
+{
+    return event_ring;
+}
+
+/**
+ * @brief Takes a snapshot of the dispatch counters and latency histograms.
+ *
+ * @details
+ * Copies with relaxed loads while the signal thread keeps recording, so it
+ * never blocks dispatch. Only signals received at least once appear in
+ * `SignalStats::signals`.
+ *
+ * @return The current statistics.
+ */
+SignalStats SignalHandler::stats() const
+{
+    SignalStats out;
+    metrics.snapshot(out);
+
+    // The throttle counts what it withheld; only it knows a record is final
+    for (SignalStats::PerSignal &entry : out.signals)
+    {
+        entry.suppressed = signal_throttle.suppressed(entry.signo);
+        out.suppressed += entry.suppressed;
+    }
+    return out;
+}
+
+/**
+ * @brief Creates the shared-memory event log and attaches it to the crash path.
+ *
+ * @details
+ * Should be called before `start()`; the dispatching thread appends to the
+ * log without synchronization beyond the log's own atomics. The crash path
+ * appends its record to the same log, so a supervisor sees the last signals
+ * and the fatal one in a single file.
+ *
+ * @param path File to create, or nullptr for a memfd.
+ * @param capacity Number of records kept.
+ * @return `true` if the log was created.
+ */
+bool SignalHandler::enableEventLog(const char *path, std::size_t capacity)
+{
+    if (running.load() || !event_log.create(path, capacity))
+    {
+        return false;
+    }
+
+    SignalCrashHandler::setEventLog(&event_log);
+    return true;
+}
+
+/**
+ * @brief Returns the shared-memory event log.
+ *
+ * @return The event log owned by this handler.
+ */
+const SignalEventLog &SignalHandler::eventLog() const
+{
+    return event_log;
+}
+
+/**
+ * @brief Returns a stop token bound to this handler.
+ *
+ * @details
+ * The handler triggers the token itself when the first non-immediate signal
+ * arrives, before the callback runs, so most consumers no longer need a
+ * callback at all for graceful shutdown.
+ *
+ * @return A token observing the handler's stop source.
+ */
+SignalStopToken SignalHandler::getStopToken() const
+{
+    return SignalStopToken(stop_source);
+}
+
+/**
+ * @brief Triggers the stop token from application code.
+ *
+ * @details Begins the shutdown coordinator too, but never escalates it.
+ *
+ * @return `true` if this call triggered the token.
+ */
+bool SignalHandler::requestStop()
+{
+    if (shutdown_coordinator.hasHooks())
+    {
+        shutdown_coordinator.begin();
+    }
+    return stop_source.requestStop();
+}
+
+/**
+ * @brief Sets the grace budget.
+ *
+ * @param budget The grace period.
+ * @param margin Head start on SIGKILL.
+ * @return `true` if stored.
+ */
+bool SignalHandler::setGraceBudget(std::chrono::milliseconds budget, std::chrono::milliseconds margin)
+{
+    return SignalGrace::configure(budget, margin);
+}
+
+/**
+ * @brief Returns the time left in the grace budget.
+ *
+ * @return The time left.
+ */
+std::chrono::milliseconds SignalHandler::remainingBudget() const
+{
+    return SignalGrace::remaining();
+}
+
+/**
+ * @brief Returns the shutdown coordinator.
  *
- * @note
- * This method should be called before `start()` to ensure the callback is
- * available when signals are received.
+ * @return The coordinator owned by this handler.
  */
-void SignalHandler::setCallback(const std::function<void(int, bool)> &cb)
+SignalShutdown &SignalHandler::shutdown()
 {
-    // Store the user-provided signal handler callback
-    callback = cb;
+    return shutdown_coordinator;
 }
 
 /**
  * @brief Converts a signal number to its corresponding name string.
  *
  * @details
- * Looks up the given signal number in the `signal_map` and returns the
- * associated signal name as a `std::string_view`. If the signal is not found
- * in the map, the function returns `"UNKNOWN"`.
+ * Indexes `signal_table` with the given signal number and returns the
+ * associated signal name as a `std::string_view`. Real-time signals are
+ * named relative to SIGRTMIN. Otherwise, if the signal has no name in the
+ * table, the function returns `"UNKNOWN"`.
  *
  * @param signum The signal number to look up.
  * @return A string view of the signal name, or `"UNKNOWN"` if not found.
  */
 std::string_view SignalHandler::signalToString(int signum)
 {
-    // Attempt to find the signal number in the signal map
-    auto it = signal_map.find(signum);
-    if (it != signal_map.end())
+    if (signum > 0 && signum < signal_limit && !signal_table[signum].name.empty())
     {
-        return it->second.first; // Return the signal name
+        return signal_table[signum].name; // Return the signal name
     }
 
-    // Signal not recognized in the map
+    if (isRealtime(signum))
+    {
+        // Names relative to the runtime SIGRTMIN, built once on first use
+        static const auto rt_names = []
+        {
+            std::array<std::array<char, 16>, signal_limit> names{};
+            for (int sig = SIGRTMIN; sig <= SIGRTMAX; ++sig)
+            {
+                if (sig == SIGRTMAX)
+                    snprintf(names[sig].data(), names[sig].size(), "SIGRTMAX");
+                else
+                    snprintf(names[sig].data(), names[sig].size(), "SIGRTMIN+%d", sig - SIGRTMIN);
+            }
+            return names;
+        }();
+        return rt_names[signum].data();
+    }
+
+    // Signal not recognized in the table
     return "UNKNOWN";
 }
 
@@ -299,13 +2246,18 @@ std::string_view SignalHandler::signalToString(int signum)
  * @brief Stops the signal handling thread and restores terminal state.
  *
  * @details
+ * In signalfd mode there is no thread to wake, so the descriptor is simply
+ * closed before leaving the registry.
+ *
  * Initiates a graceful shutdown of the signal handling mechanism.
  * If the signal handling thread is running and a stop hasn't already been
  * requested, this function:
  * - Marks `stop_requested` as true.
- * - Sends a dummy signal (SIGUSR1) to interrupt a blocked `sigwait()`.
+ * - Sends the private wake-up signal to interrupt a blocked `sigwait()`.
  * - Joins the worker thread to wait for its completion.
- * - Restores the original terminal settings, if previously modified.
+ * - Completes any queued `addWaiter()` waiters with an empty `siginfo_t`.
+ * - Leaves `SignalRegistry`; the last instance to leave restores the
+ *   signal mask and the original terminal settings.
  *
  * @return `true` if the stop procedure was initiated and completed,
  *         `false` if the signal handler was already stopped or a stop was already in progress.
@@ -325,20 +2277,44 @@ bool SignalHandler::stop()
     // Request stop and interrupt the signal-waiting thread
     stop_requested.store(true);
 
+    if (signal_fd >= 0)
+    {
+        // No thread to wake in signalfd mode, just release the descriptor
+        thread_watchdog.disarm();
+        signal_throttle.disarm();
+        finishProfile();
+        close(signal_fd);
+        signal_fd = -1;
+        rcu.unregisterReader(rcu_reader);
+        rcu_reader = -1;
+        running.store(false);
+        stopPool();
+        cancelWaiters();
+        release();
+        return true;
+    }
+
     // Send a signal from our set to wake up the blocked sigwait in run()
-    pthread_kill(worker_thread.native_handle(), SIGUSR1);
+    wake();
 
     // Wait for the signal handling thread to finish
-    if (worker_thread.joinable())
+    if (worker_started.exchange(false, std::memory_order_acq_rel))
     {
-        worker_thread.join();
+        pthread_join(worker_thread, nullptr);
     }
+    joinShards();
 
-    // Restore terminal settings if they were previously saved
-    if (termios_saved)
-    {
-        tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
-    }
+    // Shard-owned throttle slots are only safe to touch once the shards exit
+    signal_throttle.disarm();
+
+    // Let queued deliveries finish; nothing will dispatch from here on
+    stopPool();
+
+    // Release anyone still waiting
+    cancelWaiters();
+
+    // The last instance out restores the signal mask and terminal settings
+    release();
 
     return true;
 }
@@ -367,7 +2343,7 @@ bool SignalHandler::stop()
 bool SignalHandler::setPriority(int schedPolicy, int priority)
 {
     // Ensure that the worker thread is active and joinable
-    if (!running.load() || !worker_thread.joinable())
+    if (!running.load() || !worker_started.load(std::memory_order_acquire))
     {
         return false;
     }
@@ -377,11 +2353,48 @@ bool SignalHandler::setPriority(int schedPolicy, int priority)
     sch_params.sched_priority = priority;
 
     // Attempt to apply the scheduling policy and priority
-    int ret = pthread_setschedparam(worker_thread.native_handle(), schedPolicy, &sch_params);
+    int ret = pthread_setschedparam(worker_thread, schedPolicy, &sch_params);
 
     return (ret == 0);
 }
 
+/**
+ * @brief Chooses how a forked child treats this handler.
+ *
+ * @param mode The mode applied by `afterFork()`.
+ */
+void SignalHandler::setForkMode(ForkMode mode)
+{
+    fork_mode.store(mode);
+}
+
+/**
+ * @brief Sets the terminal mode.
+ *
+ * @param mode Applied at the next start.
+ * @return `true` if recorded, `false` if already running.
+ */
+bool SignalHandler::setTerminalMode(TerminalMode mode)
+{
+    if (running.load())
+    {
+        return false;
+    }
+
+    terminal_mode = mode;
+    return true;
+}
+
+/**
+ * @brief Restores the signal mask and terminal settings before `exec()`.
+ *
+ * @param restore_terminal Also restore the terminal settings.
+ */
+void SignalHandler::prepareExec(bool restore_terminal)
+{
+    SignalRegistry::instance().restoreForExec(restore_terminal);
+}
+
 /**
  * @brief Main loop for the signal handling thread.
  *
@@ -408,32 +2421,33 @@ void SignalHandler::run()
     std::cout << "Signal thread running, waiting for signals." << std::endl;
 #endif
 
-    // Build a local signal set from the static signal map
-    sigset_t local_set;
-    if (sigemptyset(&local_set) != 0)
-    {
-#ifdef DEBUG_SIGNAL_HANDLER
-        perror("sigemptyset");
-#endif
-        return;
-    }
+    // This thread is the only reader of the handler slots in thread mode
+    rcu_reader = rcu.registerReader();
+    dispatch_tid = static_cast<int>(syscall(SYS_gettid));
+    armWatchdog();
 
-    for (const auto &entry : signal_map)
+    // Off the caller's startup path; stop() joins this thread before release()
+    if (terminal_mode == TerminalMode::Async)
     {
-        if (sigaddset(&local_set, entry.first) != 0)
-        {
-#ifdef DEBUG_SIGNAL_HANDLER
-            perror("sigaddset");
-#endif
-            // Continue building set despite failures
-        }
+        applyTerminalMode();
     }
 
     // Main signal-handling loop
+    sigset_t local_set;
+    std::uint64_t waited_mask = 0;
+    siginfo_t batch[batch_capacity];
     while (running.load() && !stop_requested.load())
     {
-        siginfo_t siginfo;
-        int sig = sigwaitinfo(&local_set, &siginfo);
+        // Pick up signals added by registerHandler() since the last wait
+        std::uint64_t mask = waitMask() & ~shard_mask;
+        if (mask != waited_mask)
+        {
+            maskToSet(mask, local_set);
+            sigaddset(&local_set, wakeSignal());
+            waited_mask = mask;
+        }
+
+        int sig = sigwaitinfo(&local_set, &batch[0]);
 
         // If shutdown was requested while waiting, exit immediately
         if (stop_requested.load())
@@ -441,38 +2455,451 @@ void SignalHandler::run()
             break;
         }
 
-        // Filter our own wake-up signal (if you left it mapped)
-        if (sig == SIGUSR1)
+        if (sig < 0)
+        {
+            continue; // Interrupted, wait again
+        }
+
+        std::int64_t woke_ns = SignalMetrics::now();
+
+        // In batch mode, or to coalesce, drain whatever else is already pending
+        std::size_t count = 1;
+        if (batch_callback || signal_throttle.coalescing())
+        {
+            const timespec zero = {0, 0};
+            while (count < batch_capacity &&
+                   sigtimedwait(&local_set, &batch[count], &zero) > 0)
+            {
+                ++count;
+            }
+        }
+
+        dispatchBatch(batch, count, woke_ns);
+
+        // Signals other instances received on our behalf
+        drainInbox();
+    }
+
+    // The throttle is left to stop(); shards may still be using it
+    thread_watchdog.disarm();
+    finishProfile();
+    rcu.unregisterReader(rcu_reader);
+    rcu_reader = -1;
+
+    // Mark the handler as no longer running
+    running.store(false);
+}
+
+/**
+ * @brief Entry point of a shard thread.
+ *
+ * @param shard The Shard the thread serves.
+ * @return Always nullptr.
+ */
+void *SignalHandler::shardMain(void *shard)
+{
+    auto *self = static_cast<Shard *>(shard);
+
+    if (!nameThread(self->options.name))
+    {
+        self->owner->options_applied.store(false);
+    }
+
+    self->owner->runShard(*self);
+    return nullptr;
+}
+
+/**
+ * @brief Signal loop of a shard thread.
+ *
+ * @details
+ * Like `run()`, but the wait set is the shard's registered signals plus
+ * the wake-up signal, which also carries its throttle releases. Pending
+ * records are always drained, up to `batch_capacity`, so a burst costs
+ * one wakeup. Records forwarded by other instances are drained from the
+ * shard's own inbox. Stopping is left to the main thread: `stop()` joins
+ * the shards after it.
+ *
+ * @param shard The shard.
+ */
+void SignalHandler::runShard(Shard &shard)
+{
+    shard.reader = rcu.registerReader();
+    shard.tid = static_cast<int>(syscall(SYS_gettid));
+
+    sigset_t local_set;
+    std::uint64_t waited_mask = ~std::uint64_t{0};
+    siginfo_t batch[batch_capacity];
+    while (running.load() && !stop_requested.load())
+    {
+        // Records of our signals that another instance received, including
+        // any forwarded before this thread could be woken
+        drainInbox(&shard);
+
+        // Pick up the shard's signals as registerHandler() adds them
+        std::uint64_t mask = waitMask() & shard.mask;
+        if (mask != waited_mask)
+        {
+            maskToSet(mask, local_set);
+            sigaddset(&local_set, wakeSignal());
+            waited_mask = mask;
+        }
+
+        if (sigwaitinfo(&local_set, &batch[0]) < 0 || stop_requested.load())
+        {
+            continue;
+        }
+
+        std::int64_t woke_ns = SignalMetrics::now();
+
+        std::size_t count = 1;
+        const timespec zero = {0, 0};
+        while (count < batch_capacity && sigtimedwait(&local_set, &batch[count], &zero) > 0)
+        {
+            ++count;
+        }
+
+        dispatchBatch(batch, count, woke_ns, false, &shard);
+    }
+
+    rcu.unregisterReader(shard.reader);
+    shard.reader = -1;
+}
+
+/**
+ * @brief Reports whether a later record in the batch has the same signal.
+ *
+ * @details Used for `SignalThrottle::Mode::LatestWins`; batches hold at
+ * most `batch_capacity` records, so the scan is short.
+ *
+ * @param records The batch.
+ * @param index The record to check.
+ * @param count Records in the batch.
+ * @return `true` if the record is superseded.
+ */
+static bool supersededInBatch(const siginfo_t *records, std::size_t index, std::size_t count)
+{
+    for (std::size_t k = index + 1; k < count; ++k)
+    {
+        if (records[k].si_signo == records[index].si_signo)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Filters a drained batch and dispatches it.
+ *
+ * @details
+ * Drops the internal wake-up signal, counts anything not in the wait set as
+ * dropped, and
+ * publishes every remaining record to the event ring and, if enabled, the
+ * shared-memory event log. The whole batch runs
+ * inside one RCU read-side section:
+ * - Signals with a registered handler go straight to that handler, after
+ *   triggering the stop token if the handler asked for it.
+ * - Other table signals trigger the stop token if they are not immediate,
+ *   then go to the batch callback in one call if one is set, otherwise
+ *   through `dispatch()` one at a time.
+ * - Signals that were registered and later unregistered are ignored.
+ *
+ * Each delivery is timed against `woke_ns` for `stats()`. Records received
+ * directly are first fanned out to the other instances waiting on them.
+ * A shard publishes to its own ring and runs its handlers inline; it
+ * never sees a handled signal, so the callbacks only ever run on the main
+ * thread.
+ *
+ * @param records Records drained in one wakeup; compacted in place.
+ * @param count Number of valid records.
+ * @param woke_ns `SignalMetrics::now()` when the wait returned.
+ * @param forwarded `true` if the records came from another instance.
+ * @param shard The shard dispatching, or nullptr for the main thread.
+ * @return The number of records delivered to a handler, waiter or callback.
+ */
+std::size_t SignalHandler::dispatchBatch(siginfo_t *records, std::size_t count,
+                                         std::int64_t woke_ns, bool forwarded, Shard *shard)
+{
+    // A shard thread has its own reader slot, thread id and ring
+    int tid = shard != nullptr ? shard->tid : dispatch_tid;
+    SignalEventRing &ring = shard != nullptr ? shard->events : event_ring;
+
+    SignalRcu::ReadGuard guard(rcu, shard != nullptr ? shard->reader : rcu_reader);
+    std::uint64_t mask = waitMask();
+
+    std::size_t kept = 0;
+    std::size_t received = 0;
+    std::size_t delivered = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        siginfo_t &info = records[i];
+        int sig = info.si_signo;
+
+        if (isWakeSignal(info))
+            continue;
+
+        // Watchdog and profiler ticks share the wake-up signal
+        if (sig == wakeSignal() && thread_watchdog.isTick(info))
+        {
+            thread_watchdog.scan();
+            continue;
+        }
+        if (sig == wakeSignal() && sampling_profiler.isTick(info))
+        {
+            if (sampling_profiler.onTick())
+            {
+                finishProfile();
+            }
+            continue;
+        }
+
+        // So do throttle releases, which bring back a held record in place
+        bool released = false;
+        if (sig == wakeSignal() && signal_throttle.isTick(info))
+        {
+            siginfo_t tick = info;
+            if (!signal_throttle.release(tick, info, SignalMetrics::now(), wakeSignal(), tid))
+            {
+                continue;
+            }
+            sig = info.si_signo;
+            released = true;
+        }
+
+        // A released record was received, shared and published when it arrived
+        if (!released)
+        {
+            // Only one instance consumes a process signal; share it with the rest
+            if (!forwarded)
+            {
+                SignalRegistry::instance().fanOut(registry_slot, info);
+            }
+
+            ++received;
+            metrics.onReceived(sig);
+        }
+
+        // Filter anything we are no longer waiting on
+        if (sig <= 0 || sig >= signal_limit || (mask & signalBit(sig)) == 0)
+        {
+            metrics.onDropped();
+            continue;
+        }
+
+        if (!released)
+        {
+            // Make the event visible to polling workers before any callback runs
+            ring.publish(info);
+            event_log.append(SignalEventLog::Kind::Signal, info, tid);
+
+            // Observers see every record; the throttle decides who else does
+            if (signal_throttle.active(sig) &&
+                !signal_throttle.admit(info, supersededInBatch(records, i, count),
+                                       SignalMetrics::now(), wakeSignal(), tid))
+            {
+                continue;
+            }
+        }
+
+        // Coroutines and other waiters see the signal before its handler runs
+        bool awaited = waiters.load(std::memory_order_relaxed) != nullptr && completeWaiters(info);
+
+        const HandlerSlot *slot = handler_slots[sig].load(std::memory_order_acquire);
+        if (slot != nullptr)
+        {
+            ++delivered;
+            if (slot->flags & HandlerFlags::RequestStop)
+            {
+                onStopSignal();
+            }
+
+            // Recorded and queued; the signal thread goes back to waiting. A
+            // shard keeps its deliveries on its own thread and node
+            if (shard == nullptr && !(slot->flags & HandlerFlags::Immediate) &&
+                deferDelivery(info, woke_ns))
+            {
+                continue;
+            }
+
+            std::int64_t entry_ns = SignalMetrics::now();
+            slot->handler(info);
+            metrics.onDispatched(sig, woke_ns, entry_ns, SignalMetrics::now());
+
+            if (slot->flags & HandlerFlags::Immediate)
+            {
+                std::exit(EXIT_FAILURE);
+            }
             continue;
+        }
 
-        // Skip any signal not in the map (i.e. UNKNOWN)
-        auto it = signal_map.find(sig);
-        if (it == signal_map.end())
+        if (!isHandled(sig))
+        {
+            // Watched or unregistered runtime signal, seen only by waiters
+            if (awaited)
+            {
+                ++delivered;
+            }
+            else
+            {
+                metrics.onDropped();
+            }
             continue;
+        }
+
+        // Non-immediate signals request a graceful stop
+        if (!isImmediate(sig))
+        {
+            onStopSignal();
+        }
+
+        records[kept++] = info;
+    }
+
+    metrics.onWakeup(received);
+    delivered += kept;
 
-        // Now we know it’s one we really care about.
-        bool immediate = it->second.second;
+    if (kept == 0)
+    {
+        return delivered;
+    }
+
+    if (batch_callback)
+    {
+        // The whole batch shares one call, so each record gets its timing
+        std::int64_t entry_ns = SignalMetrics::now();
+        batch_callback(records, kept);
+        std::int64_t exit_ns = SignalMetrics::now();
+        for (std::size_t i = 0; i < kept; ++i)
+        {
+            metrics.onDispatched(records[i].si_signo, woke_ns, entry_ns, exit_ns);
+        }
+        return delivered;
+    }
+
+    for (std::size_t i = 0; i < kept; ++i)
+    {
+        // Immediate signals never wait behind queued work
+        if (callback && !isImmediate(records[i].si_signo) && deferDelivery(records[i], woke_ns))
+        {
+            continue;
+        }
 
-        // Invoke the user callback
+        std::int64_t entry_ns = SignalMetrics::now();
+        dispatch(records[i]);
         if (callback)
         {
+            metrics.onDispatched(records[i].si_signo, woke_ns, entry_ns, SignalMetrics::now());
+        }
+    }
+    return delivered;
+}
+
+/**
+ * @brief Routes a single received signal to the user callback.
+ *
+ * @details
+ * Invokes the callback with the signal's "immediate" flag, if one is set.
+ * Otherwise exits the process if the signal is marked immediate.
+ *
+ * @param info The signal information received.
+ */
+void SignalHandler::dispatch(const siginfo_t &info)
+{
+    int sig = info.si_signo;
+    bool immediate = isImmediate(sig);
+
+    // Invoke the user callback
+    if (callback)
+    {
 #ifdef DEBUG_SIGNAL_HANDLER
-            std::cout << "Callback requested for signal: "
-                      << SignalHandler::signalToString(sig) << std::endl;
-            std::cout << std::flush;
+        std::cout << "Callback requested for signal: "
+                  << SignalHandler::signalToString(sig) << std::endl;
+        std::cout << std::flush;
 #endif
-            callback(sig, immediate);
+        callback(sig, immediate);
+    }
+    else
+    {
+        // No callback provided — exit immediately if signal is fatal
+        if (immediate)
+        {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * @brief Triggers the stop token and drives the shutdown coordinator.
+ *
+ * @details
+ * The first stop signal starts the grace budget, if one is set, and the
+ * coordinator's phases on their own thread, so the signal thread keeps
+ * waiting and can see a second one. A
+ * stop signal that arrives while the phases are still running escalates
+ * to a forced exit; one that arrives after they finished is ignored.
+ *
+ * The phases start before the stop token is triggered, so a thread woken
+ * by the token that calls `requestStop()` and `shutdown().wait()` always
+ * finds them running. Whether a stop signal is the first is tracked here
+ * rather than inferred from `begin()`, which that `requestStop()` may
+ * have won.
+ */
+void SignalHandler::onStopSignal()
+{
+    // The supervisor's clock starts with its first signal
+    SignalGrace::begin();
+
+    bool repeated = stop_signalled.exchange(true);
+    if (shutdown_coordinator.hasHooks())
+    {
+        if (!repeated)
+        {
+            // Running before the token wakes anyone; losing to their
+            // requestStop() still leaves it running, which is all we need
+            shutdown_coordinator.begin();
         }
         else
         {
-            // No callback provided — exit immediately if signal is fatal
-            if (immediate)
-            {
-                std::exit(EXIT_FAILURE);
-            }
+            shutdown_coordinator.escalate();
         }
     }
 
-    // Mark the handler as no longer running
-    running.store(false);
+    stop_source.requestStop();
+}
+
+/**
+ * @brief Returns the signals the handler should block and wait on.
+ *
+ * @details
+ * Once SignalCrashHandler is installed it owns the fault signals: they are
+ * delivered synchronously to the faulting thread and must stay unblocked,
+ * so they are removed from every set the handler builds.
+ *
+ * @return The current wait mask in `signalBit()` layout.
+ */
+std::uint64_t SignalHandler::waitMask() const
+{
+    std::uint64_t mask = active_mask.load(std::memory_order_acquire);
+    if (SignalCrashHandler::installed())
+    {
+        mask &= ~SignalCrashHandler::fault_mask;
+    }
+    return mask;
+}
+
+/**
+ * @brief Interrupts the signal thread's wait.
+ *
+ * @details
+ * Sends the wake-up signal directly to the signal thread, where it is
+ * blocked and part of the wait set, so it is consumed by `sigwaitinfo()`
+ * and then recognized and dropped by `dispatchBatch()`.
+ */
+void SignalHandler::wake()
+{
+    if (worker_started.load(std::memory_order_acquire))
+    {
+        pthread_kill(worker_thread, wakeSignal());
+    }
 }
@@ -31,26 +31,54 @@
 #define SIGNAL_HANDLER_HPP
 
 // Standard Libraries
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <csignal>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
-#include <thread>
-#include <unordered_map>
+#include <vector>
 
 // System libraries
-#include <termios.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/types.h>
+
+// Project libraries
+#include "signal_child.hpp"
+#include "signal_crash.hpp"
+#include "signal_dump.hpp"
+#include "signal_event_log.hpp"
+#include "signal_event_ring.hpp"
+#include "signal_function.hpp"
+#include "signal_grace.hpp"
+#include "signal_group.hpp"
+#include "signal_pool.hpp"
+#include "signal_profiler.hpp"
+#include "signal_rcu.hpp"
+#include "signal_registry.hpp"
+#include "signal_reload.hpp"
+#include "signal_shutdown.hpp"
+#include "signal_stats.hpp"
+#include "signal_stop_token.hpp"
+#include "signal_throttle.hpp"
+#include "signal_watchdog.hpp"
 
 /**
- * @brief Block all signals registered in SignalHandler::signal_map.
- * @details Constructs a signal set by iterating over the signal_map from the
- *          SignalHandler class and blocks all the signals using pthread_sigmask.
+ * @brief Block all signals marked handled in SignalHandler::signal_table.
+ * @details Uses the precomputed signal set from the SignalHandler class and
+ *          blocks all the signals using pthread_sigmask.
  *
  *          This is commonly used in multithreaded environments to delegate
  *          signal handling to a dedicated thread, while blocking signal
  *          delivery to others.
  *
- * @note Only blocks signals listed in SignalHandler::signal_map.
+ * @note Only blocks signals marked handled in SignalHandler::signal_table.
+ * @note Fault signals are left unblocked once SignalCrashHandler is installed.
  * @note Requires linking with -pthread.
  *
  * @throws None, but will print an error to stderr if pthread_sigmask fails,
@@ -58,6 +86,31 @@
  */
 void block_signals();
 
+/**
+ * @brief An allocation-free request to be told about the next matching signal.
+ *
+ * @details
+ * The caller owns the node, e.g. inside a coroutine frame, and hands it to
+ * `SignalHandler::addWaiter()`. The dispatching thread fills in `info` and
+ * calls `complete` exactly once, either for the next signal in `mask` or,
+ * with `info.si_signo == 0`, when the handler stops. The node must stay
+ * alive until then.
+ */
+struct SignalWaiter
+{
+    std::uint64_t mask = 0;                     ///< Signals to wait for (`signalBit()` layout).
+    siginfo_t info{};                           ///< The signal that completed the wait.
+    void (*complete)(SignalWaiter *) = nullptr; ///< Completion, called once.
+    void *context = nullptr;                    ///< Owner data for `complete`.
+    SignalWaiter *next = nullptr;               ///< List link, owned by SignalHandler.
+};
+
+#ifdef __cpp_impl_coroutine
+class SignalInlineExecutor;
+template <typename Executor>
+class SignalAwaitable;
+#endif
+
 /**
  * @brief Manages signal handling in a multi-threaded environment.
  *
@@ -66,16 +119,104 @@ void block_signals();
  * thread, allowing controlled asynchronous signal responses via user-defined
  * callbacks or immediate shutdown behavior.
  *
- * Signals are defined via a static `signal_map`, which maps each signal number
- * to a human-readable name and a boolean indicating whether it requires an
- * immediate process termination.
+ * Signals are defined via a constexpr `signal_table`, indexed by signal
+ * number, which holds a human-readable name, whether the signal is handled,
+ * and whether it requires an immediate process termination.
+ *
+ * Individual signals can also be given their own handler at runtime with
+ * `registerHandler()`, including signals that are not in the table.
  *
  * Terminal control characters (like ^C) can also be suppressed during the
  * lifetime of the signal handler.
+ *
+ * Any number of instances may run at once. They share one reference-counted
+ * signal mask and terminal state through `SignalRegistry`, which also fans
+ * each received signal out to every instance that waits on it.
  */
 class SignalHandler
 {
+    friend class SignalRegistry;
+
 public:
+    /**
+     * @brief Per-signal handler invoked with the full signal information.
+     *
+     * @details Stored inline with no heap allocation; captures larger than
+     * `signal_function_capacity` bytes fail to compile.
+     */
+    using Handler = SignalInplaceFunction<void(const siginfo_t &)>;
+
+    /**
+     * @brief The parts of a queued signal that carry a payload.
+     */
+    struct SignalPayload
+    {
+        int signo;    ///< The real-time signal number.
+        int code;     ///< `si_code`; SI_QUEUE for `sigqueue()`/`send()`.
+        sigval value; ///< The value passed to `sigqueue()`.
+        pid_t pid;    ///< Sending process.
+        uid_t uid;    ///< Real user ID of the sender.
+    };
+
+    /**
+     * @brief Typed handler for queued real-time signals.
+     *
+     * @details Smaller than `Handler` so that the wrapper `registerQueuedHandler()`
+     * builds around it still fits inline.
+     */
+    using PayloadHandler = SignalInplaceFunction<void(const SignalPayload &), 40>;
+
+    /**
+     * @brief Callback for `setCallback()`: (signal number, immediate).
+     */
+    using Callback = SignalInplaceFunction<void(int, bool)>;
+
+    /**
+     * @brief Callback for `setBatchCallback()`: (records, count).
+     */
+    using BatchCallback = SignalInplaceFunction<void(const siginfo_t *, std::size_t)>;
+
+    /**
+     * @brief Options for a handler registered with `registerHandler()`.
+     */
+    enum class HandlerFlags : unsigned
+    {
+        None = 0,             ///< Just run the handler.
+        RequestStop = 1 << 0, ///< Trigger the stop token before the handler.
+        Immediate = 1 << 1    ///< Exit the process after the handler returns.
+    };
+
+    /**
+     * @brief Where a signal's handler or callback runs.
+     */
+    enum class DispatchPolicy : std::uint8_t
+    {
+        Inline = 0,    ///< On the dispatching thread (the default).
+        Pooled = 1,    ///< On any pool worker; deliveries may run concurrently.
+        Serialized = 2 ///< On the signal's own pool worker, one at a time, in order.
+    };
+
+    /**
+     * @brief What a running handler becomes in a child after `fork()`.
+     */
+    enum class ForkMode : std::uint8_t
+    {
+        Keep = 0,    ///< No signal thread; signals stay blocked (the default).
+        Respawn = 1, ///< Restart the signal thread, or re-create the signalfd.
+        Detach = 2   ///< Stop, restoring the signals to their default actions.
+    };
+
+    /**
+     * @brief How `start()` and `startSignalFd()` treat the terminal on stdin.
+     */
+    enum class TerminalMode : std::uint8_t
+    {
+        Auto = 0,  ///< Only if stdin is the foreground terminal (the default).
+        Skip = 1,  ///< Never touch the terminal.
+        Sync = 2,  ///< Always try, as earlier versions did.
+        Async = 3  ///< As `Auto`, but on the signal thread after `start()` returns.
+    };
+
     /**
      * @brief Status codes for potential future extension.
      */
@@ -105,6 +246,35 @@ public:
      */
     void start();
 
+    /**
+     * @brief Prepares signal handling for an external event loop.
+     *
+     * @details Performs the same terminal and signal mask setup as `start()`,
+     * but instead of spawning a thread it creates a non-blocking `signalfd`
+     * over the signal set. The caller adds the descriptor to its own
+     * epoll/io_uring loop and calls `dispatchPending()` when it is readable.
+     *
+     * @return The signalfd descriptor, or -1 on failure or if shards were added.
+     */
+    int startSignalFd();
+
+    /**
+     * @brief Returns the descriptor created by `startSignalFd()`.
+     *
+     * @return The signalfd descriptor, or -1 if not in signalfd mode.
+     */
+    int getSignalFd() const;
+
+    /**
+     * @brief Reads and dispatches all signals queued on the signalfd.
+     *
+     * @details Intended to be called from the caller's event loop whenever
+     * the signalfd is readable. Never blocks.
+     *
+     * @return The number of signals dispatched, or -1 if not in signalfd mode.
+     */
+    int dispatchPending();
+
     /**
      * @brief Sets the user-defined callback to handle signals.
      *
@@ -114,88 +284,1269 @@ public:
      *
      * @param cb A function accepting (int signal_number, bool immediate).
      */
-    void setCallback(const std::function<void(int, bool)> &cb);
+    void setCallback(const Callback &cb);
 
     /**
-     * @brief Stops the signal handling thread and restores terminal settings.
+     * @brief Sets a callback that receives every signal drained in one wakeup.
      *
-     * @return true if the thread was stopped successfully, false if already stopped.
+     * @details When set, each wakeup drains all pending handled signals
+     * (up to `batch_capacity`) with `sigtimedwait()` in thread mode, or with
+     * a single multi-record `read()` in signalfd mode, and passes them to
+     * this callback in one call. Takes precedence over `setCallback()`.
+     *
+     * @param cb A function accepting (const siginfo_t *records, std::size_t count).
      */
-    bool stop();
+    void setBatchCallback(const BatchCallback &cb);
 
     /**
-     * @brief Sets thread scheduling policy and priority for the signal thread.
+     * @brief Reports whether a signal is marked "immediate" in `signal_table`.
      *
-     * @param schedPolicy One of SCHED_FIFO, SCHED_RR, or SCHED_OTHER.
-     * @param priority Desired priority level for the thread.
-     * @return true if the change succeeded, false otherwise.
+     * @param signum The signal number to check.
+     * @return true if the signal is handled and marked immediate.
      */
-    bool setPriority(int schedPolicy, int priority);
+    static bool isImmediate(int signum);
 
     /**
-     * @brief Converts a signal number to its string representation.
+     * @brief Installs or replaces the handler for one signal.
      *
-     * @param signum The signal number to convert.
-     * @return A string view of the signal name or "UNKNOWN" if not found.
+     * @details The handler takes precedence over `setCallback()` and
+     * `setBatchCallback()` for that signal. Signals that are not handled by
+     * default (SIGUSR1, SIGUSR2, SIGWINCH, SIGCHLD, real-time signals, ...)
+     * are added to the wait set; they must also be blocked in every other
+     * thread, as with `block_signals()`.
+     *
+     * Replacement is lock-free for the dispatching thread: the new slot is
+     * published with an atomic pointer swap and the old one is reclaimed
+     * after an RCU grace period.
+     *
+     * @param signum The signal number to handle.
+     * @param handler The function to invoke with the signal information.
+     * @param flags Handler options.
+     * @return true on success, false for invalid or uncatchable signals, the
+     *         `wakeSignal()`, or if called from a handler on the dispatching
+     *         thread.
      */
-    static std::string_view signalToString(int signum);
+    bool registerHandler(int signum, const Handler &handler,
+                         HandlerFlags flags = HandlerFlags::None);
 
     /**
-     * @brief Static map of signals to handle.
+     * @brief Starts worker threads that run handlers off the dispatching thread.
      *
-     * @details Each entry maps a signal number to:
-     * - A string view representing the signal name.
-     * - A boolean indicating if it is an "immediate" signal (requires forced shutdown).
+     * @details Signals whose policy is not `Inline` are recorded and queued
+     * by the signal thread, which goes straight back to waiting. Each worker
+     * has a preallocated queue; when it is full the delivery runs inline
+     * instead, so nothing is dropped. Signals marked immediate, and the
+     * batch callback, always run inline. Call before `start()`.
+     *
+     * @param threads Number of workers, up to `SignalDispatchPool::max_workers`.
+     * @param queue_capacity Jobs per worker queue.
+     * @return false if running, already enabled, or the arguments are invalid.
      */
-    static const std::unordered_map<int, std::pair<std::string_view, bool>> signal_map;
+    bool enableDispatchPool(std::size_t threads = 2, std::size_t queue_capacity = 256);
 
-private:
     /**
-     * @brief Worker thread that runs in the signal loop.
+     * @brief Chooses where a signal's handler or callback runs.
+     *
+     * @details Has no effect for signals marked immediate, or without a pool.
+     *
+     * @param signum The signal number.
+     * @param policy The policy.
+     * @return false for an invalid signal.
      */
-    std::thread worker_thread;
+    bool setDispatchPolicy(int signum, DispatchPolicy policy);
 
     /**
-     * @brief Indicates if the signal loop is active.
-     * */
-    std::atomic<bool> running;
+     * @brief Debounces, rate-limits or coalesces a signal's deliveries.
+     *
+     * @details Applies before waiters, the handler and the callback; the
+     * event ring and event log still record every record. A held record
+     * is released by a timer tick on the `wakeSignal()`, so it runs on the
+     * dispatching thread like any other delivery. Withheld records are
+     * counted in `stats()` as `suppressed`. Held records are discarded on
+     * `stop()`.
+     *
+     * @code
+     * handler.setThrottle(SIGHUP, SignalThrottle::Policy::debounce(std::chrono::milliseconds(500)));
+     * @endcode
+     *
+     * @param signum The signal number.
+     * @param policy The policy; `Policy::none()` turns throttling off.
+     * @return false for an invalid or immediate signal, the wake-up
+     *         signal, or invalid policy parameters.
+     */
+    bool setThrottle(int signum, const SignalThrottle::Policy &policy);
 
     /**
-     * @brief Flag used to break the signal wait loop.
+     * @brief Removes the handler registered for a signal.
+     *
+     * @details The signal reverts to the default table behavior. Signals
+     * added by `registerHandler()` stay blocked and are consumed and ignored,
+     * so a late arrival cannot terminate the process.
+     *
+     * @param signum The signal number.
+     * @return true if a handler was removed.
      */
-    std::atomic<bool> stop_requested;
+    bool unregisterHandler(int signum);
 
     /**
-     * @brief Suppresses callback on dummy signal during shutdown.
+     * @brief Installs a typed handler for a queued real-time signal.
+     *
+     * @details Every `sigqueue()` on the signal is delivered individually,
+     * in order, with its `si_value`, `si_pid` and `si_uid`. The signal must
+     * be blocked in every other thread, as with `registerHandler()`.
+     *
+     * @param rtsig A signal in [SIGRTMIN, SIGRTMAX], see `rtSignal()`.
+     * @param handler The function to invoke with each payload.
+     * @return true on success, false if `rtsig` is not a real-time signal.
      */
-    std::atomic<bool> stopping;
+    bool registerQueuedHandler(int rtsig, const PayloadHandler &handler);
 
     /**
-     * @brief User-provided signal handler callback.
+     * @brief Adds a signal to the wait set without giving it a handler.
+     *
+     * @details The signal is consumed and only reaches `addWaiter()` waiters
+     * and the event ring. It must be blocked in every other thread.
+     *
+     * @param signum The signal number.
+     * @return true on success, false for invalid or uncatchable signals.
      */
-    std::function<void(int, bool)> callback;
+    bool watchSignal(int signum);
 
     /**
-     * @brief Original terminal settings for STDIN.
-     * @details Used to restore terminal state after disabling control char echo.
+     * @brief Queues a waiter for the next signal in its mask.
+     *
+     * @details Lock-free and allocation-free; safe from any thread,
+     * including from a waiter's own completion. Every waiter whose mask
+     * matches a dispatched signal is completed, on the dispatching thread,
+     * in addition to the normal handler or callback. Signals in the mask
+     * must be waited on already (table signals, `registerHandler()` or
+     * `watchSignal()`).
+     *
+     * @param waiter The waiter; must stay alive until completed.
+     * @return false if the handler is not running; the waiter is not queued.
      */
-    termios original_termios;
+    bool addWaiter(SignalWaiter &waiter);
 
+#ifdef __cpp_impl_coroutine
     /**
-     * @brief Indicates whether terminal settings were successfully saved.
+     * @brief Returns an awaitable for the next signal in `set` (C++20).
+     *
+     * @details `co_await handler.next(set)` yields the `siginfo_t`. The
+     * coroutine is resumed on the dispatching thread, or posted to
+     * `executor` if one is given; with `startSignalFd()` the dispatching
+     * thread is the caller's own event loop. See signal_coro.hpp.
+     *
+     * @param set The signals to wait for.
+     * @param executor Optional executor with `post(std::coroutine_handle<>)`.
+     * @return The awaitable.
      */
-    bool termios_saved;
+    template <typename Executor = SignalInlineExecutor>
+    SignalAwaitable<Executor> next(const sigset_t &set, Executor *executor = nullptr);
+#endif
 
     /**
-     * @brief Set of signals to wait on (built from signal_map).
+     * @brief Reloads a configuration, instead of stopping, when a signal arrives.
+     *
+     * @details Installs a handler that calls `config.reload()` on the signal
+     * thread, so the loader runs off every reader's hot path. SIGHUP then no
+     * longer triggers the stop token.
+     *
+     * @tparam T The configuration type.
+     * @param config The configuration to reload; must outlive the binding.
+     * @param signum The trigger signal; SIGHUP by default.
+     * @return true if the handler was installed.
      */
-    sigset_t signal_set;
+    template <typename T>
+    bool bindReload(SignalReloadable<T> &config, int signum = SIGHUP)
+    {
+        return registerHandler(signum, [&config](const siginfo_t &)
+                               { config.reload(); });
+    }
 
     /**
-     * @brief Internal function run by the signal handling thread.
-     * @details Waits on blocked signals and triggers callbacks or exits.
+     * @brief Relays a signal to a group of child processes.
+     *
+     * @details Installs a handler that calls `group.broadcast(signum)` on
+     * the signal thread. Pass `HandlerFlags::RequestStop` to also stop this
+     * process, e.g. for SIGTERM in a prefork master; then wait for the
+     * children with `group.waitAcks()`.
+     *
+     * @param group The children; must outlive the binding.
+     * @param signum The signal to relay.
+     * @param flags Handler options for this process.
+     * @return true if the handler was installed.
      */
-    void run();
-};
+    bool bindBroadcast(SignalProcessGroup &group, int signum,
+                       HandlerFlags flags = HandlerFlags::None);
+
+    /**
+     * @brief Reaps children on the signal thread whenever SIGCHLD arrives.
+     *
+     * @details Installs a SIGCHLD handler that calls `children().reap()`,
+     * which collects every exited child in one batch per wakeup. Register
+     * per-child handlers with `children().watch()`. SIGCHLD must be blocked
+     * in every other thread, as with `registerHandler()`.
+     *
+     * @return true if the handler was installed.
+     */
+    bool enableChildReaping();
+
+    /**
+     * @brief Returns the child reaper used by `enableChildReaping()`.
+     *
+     * @return The reaper.
+     */
+    SignalChildReaper &children();
+
+    /**
+     * @brief Scans `watchdog()` heartbeats on the dispatching thread.
+     *
+     * @details A timer directs a tick at the dispatching thread every
+     * `interval`, on the private wake-up signal, so no signal is used up.
+     * Workers then call `watchdog().registerThread()` and
+     * `watchdog().beat()`. The timer is armed when the dispatching thread
+     * starts and deleted when it stops.
+     *
+     * @param interval Time between scans; a stall is detected within one
+     *                 interval of its threshold.
+     * @param handler Called on the dispatching thread for each new stall.
+     * @param backtraces Capture the stalled thread's stack first.
+     * @return false if already running or `interval` is not positive.
+     */
+    bool enableWatchdog(std::chrono::milliseconds interval,
+                        const SignalWatchdog::StallHandler &handler, bool backtraces = false);
+
+    /**
+     * @brief Returns the watchdog used by `enableWatchdog()`.
+     *
+     * @return The watchdog.
+     */
+    SignalWatchdog &watchdog();
+
+    /**
+     * @brief Profiles the process for `window` whenever `trigger` arrives.
+     *
+     * @details Each trigger starts a `SignalProfiler` window unless one is
+     * running. Rings are drained on the dispatching thread, and at the end
+     * of the window the folded stacks are written to `path`, which is
+     * truncated first. An empty path writes to stderr.
+     *
+     * @param path Output file for the folded stacks.
+     * @param window Sampling duration per trigger.
+     * @param trigger The signal that starts a window.
+     * @param hz Samples per second of CPU time.
+     * @return false if already running, the arguments are invalid, or the
+     *         trigger could not be registered.
+     */
+    bool enableProfiler(const std::string &path,
+                        std::chrono::milliseconds window = std::chrono::seconds(10),
+                        int trigger = SIGUSR2, int hz = 99);
+
+    /**
+     * @brief Returns the profiler used by `enableProfiler()`.
+     *
+     * @return The profiler.
+     */
+    SignalProfiler &profiler();
+
+    /**
+     * @brief Writes a `SignalStateDump` to `path` whenever `trigger` arrives.
+     *
+     * @details Replaces the default stop on SIGQUIT: the dispatching thread
+     * captures every thread's stack, appends `stats()` and the providers
+     * added with `stateDump().addProvider()`, and appends the result to
+     * `path` with one write. The process keeps running. An empty path
+     * writes to stderr.
+     *
+     * @param path Output file, opened in append mode on each dump.
+     * @param trigger The signal that requests a dump.
+     * @return false if already running, no real-time signal was free for
+     *         stack capture, or the trigger could not be registered.
+     */
+    bool enableStateDump(const std::string &path, int trigger = SIGQUIT);
+
+    /**
+     * @brief Returns the dumper used by `enableStateDump()`.
+     *
+     * @return The state dumper.
+     */
+    SignalStateDump &stateDump();
+
+    /**
+     * @brief Queues a real-time signal with a value to another process.
+     *
+     * @param pid The target process.
+     * @param rtsig A signal in [SIGRTMIN, SIGRTMAX].
+     * @param value The payload delivered as `si_value`.
+     * @return true if queued, false on error (e.g. EAGAIN when the
+     *         receiver's queue limit is reached, see RLIMIT_SIGPENDING).
+     */
+    static bool send(pid_t pid, int rtsig, sigval value);
+
+    /**
+     * @brief Queues a real-time signal with an integer command.
+     *
+     * @param pid The target process.
+     * @param rtsig A signal in [SIGRTMIN, SIGRTMAX].
+     * @param value The integer delivered as `si_value.sival_int`.
+     * @return true if queued.
+     */
+    static bool send(pid_t pid, int rtsig, int value);
+
+    /**
+     * @brief Maps an offset to a real-time signal number.
+     *
+     * @param offset Offset from SIGRTMIN.
+     * @return SIGRTMIN + offset, or -1 if that exceeds SIGRTMAX.
+     */
+    static int rtSignal(int offset);
+
+    /**
+     * @brief Reports whether a signal is in the real-time range.
+     *
+     * @param signum The signal number to check.
+     * @return true if SIGRTMIN <= signum <= SIGRTMAX.
+     */
+    static bool isRealtime(int signum);
+
+    /**
+     * @brief Returns the real-time signal reserved for waking the signal thread.
+     *
+     * @details `stop()` and wake-ups use a real-time signal claimed at first
+     * use, searching down from SIGRTMAX for one still at SIG_DFL, so
+     * SIGUSR1 and SIGUSR2 stay free for the application. The claimed signal
+     * cannot be registered or watched. Falls back to SIGUSR1 only if every
+     * real-time signal is already in use.
+     *
+     * @return The signal number.
+     */
+    static int wakeSignal();
+
+    /**
+     * @brief Reports whether a signal is marked handled in `signal_table`.
+     *
+     * @param signum The signal number to check.
+     * @return true if the signal is waited on by the handler.
+     */
+    static bool isHandled(int signum);
+
+    /**
+     * @brief Returns the precomputed set of handled signals.
+     *
+     * @details Built once from `handled_mask` on first use, so there is no
+     * static-initialization work and no per-call set construction.
+     *
+     * @return The set of signals marked handled in `signal_table`.
+     */
+    static const sigset_t &handledSignals();
+
+    /**
+     * @brief Returns the ring every handled signal is published to.
+     *
+     * @details Worker threads take a cursor with `events().subscribe()` and
+     * check `events().pending(cursor)` on their hot path, which is a single
+     * relaxed atomic load; no lock is shared with the signal thread.
+     *
+     * @return The broadcast event ring.
+     */
+    const SignalEventRing &events() const;
+
+    /**
+     * @brief Returns dispatch counters and per-signal latency histograms.
+     *
+     * @details Timestamps are taken from the monotonic clock when the wait
+     * returns and around every handler or callback call, so `latency` is the
+     * in-process time from wakeup to handler entry and `duration` is the time
+     * spent in the handler. Recording is a few relaxed atomic adds per
+     * signal, cheap enough to leave on; this call may run on any thread.
+     *
+     * @return A snapshot; see `SignalStats` for the counter definitions.
+     */
+    SignalStats stats() const;
+
+    /**
+     * @brief Records every dispatched signal, and crashes, in a shared-memory log.
+     *
+     * @details Creates a `SignalEventLog` of fixed-size binary records in a
+     * file (e.g. under `/dev/shm`) or a memfd, and attaches it to
+     * SignalCrashHandler as well. Appending costs a few memory stores and no
+     * system call, so it is far cheaper than logging from the callback. A
+     * supervisor can read the file after the process has died.
+     *
+     * @param path File to create, or nullptr for a memfd (see `eventLog().fd()`).
+     * @param capacity Number of records kept, rounded up to a power of two.
+     * @return true if the log was created.
+     */
+    bool enableEventLog(const char *path, std::size_t capacity = 1024);
+
+    /**
+     * @brief Returns the shared-memory log created by `enableEventLog()`.
+     *
+     * @return The event log; closed if not enabled.
+     */
+    const SignalEventLog &eventLog() const;
+
+    /**
+     * @brief Returns a token that is triggered on the first non-immediate signal.
+     *
+     * @details Replaces the usual global atomic, mutex and condition
+     * variable. Workers call `stopRequested()` (one acquire load of a padded
+     * atomic) and blocked threads call `wait()`/`waitFor()`, which sleep on a
+     * futex.
+     *
+     * @return A token bound to this handler's stop source.
+     */
+    SignalStopToken getStopToken() const;
+
+    /**
+     * @brief Triggers the stop token without a signal.
+     *
+     * @details Also begins the shutdown coordinator if it has hooks.
+     *
+     * @return true if this call triggered it, false if already triggered.
+     */
+    bool requestStop();
+
+    /**
+     * @brief Sets the termination grace budget started by the first stop signal.
+     *
+     * @details A thin wrapper over `SignalGrace::configure()`; the budget is
+     * process-wide. Without a call, `start()` and `startSignalFd()` read
+     * `SignalGrace::default_env` (`SIGNAL_GRACE_PERIOD`, in seconds). Once
+     * `budget - margin` has passed since the stop signal, the event log is
+     * synced and the process exits, ahead of the supervisor's SIGKILL.
+     *
+     * @param budget The supervisor's grace period, e.g. the pod's
+     *               `terminationGracePeriodSeconds`.
+     * @param margin How long before the end of `budget` to exit.
+     * @return false once the countdown has started, or for a non-positive budget.
+     */
+    bool setGraceBudget(std::chrono::milliseconds budget,
+                        std::chrono::milliseconds margin = SignalGrace::default_margin);
+
+    /**
+     * @brief Returns the time left before the grace budget forces an exit.
+     *
+     * @details Safe and cheap from any thread, so workers can decide whether
+     * to finish an in-flight batch or abandon it.
+     *
+     * @return The time left; `milliseconds::max()` with no budget.
+     */
+    std::chrono::milliseconds remainingBudget() const;
+
+    /**
+     * @brief Returns the phased shutdown coordinator.
+     *
+     * @details Hooks added here run, phase by phase and in parallel within a
+     * phase, on a background thread started by the first stop signal (or
+     * `requestStop()`). A second stop signal while it runs escalates to a
+     * forced exit, as does a missed phase deadline. Call
+     * `shutdown().wait()` instead of joining workers one at a time.
+     *
+     * @return The coordinator owned by this handler.
+     */
+    SignalShutdown &shutdown();
+
+    /**
+     * @brief Stops the signal handling thread and restores terminal settings.
+     *
+     * @details In signalfd mode the descriptor is closed instead.
+     *
+     * @return true if the thread was stopped successfully, false if already stopped.
+     */
+    bool stop();
+
+    /**
+     * @brief Attributes applied to the signal thread when it is created.
+     */
+    struct ThreadOptions
+    {
+        bool pin = false;        ///< Apply `affinity`.
+        cpu_set_t affinity;      ///< CPUs the thread may run on, if `pin`.
+        int policy = -1;         ///< SCHED_* policy, or -1 to inherit.
+        int priority = 0;        ///< Priority for `policy`.
+        std::size_t stack_size = 0; ///< Stack size in bytes, 0 for the default.
+        std::string name;        ///< Thread name (15 chars max), empty to inherit.
+    };
+
+    /**
+     * @brief Sets the attributes `start()` creates the signal thread with.
+     *
+     * @details Affinity, policy and stack size are set on the thread's
+     * creation attributes, so the thread never runs, even briefly, on a CPU
+     * it is not allowed on. If the policy cannot be applied (no
+     * CAP_SYS_NICE), the thread is created without it.
+     *
+     * @param options The attributes; call before `start()`.
+     * @return false if the handler is already running.
+     */
+    bool setThreadOptions(const ThreadOptions &options);
+
+    /**
+     * @brief Restricts the signal thread to a set of CPUs.
+     *
+     * @details Before `start()` this is recorded in the thread options;
+     * afterwards it is applied to the running thread.
+     *
+     * @param cpus The allowed CPUs.
+     * @return true if recorded or applied.
+     */
+    bool setAffinity(const cpu_set_t &cpus);
+
+    /**
+     * @brief Reports whether the signal thread got every requested attribute.
+     *
+     * @return false if the policy or name from `setThreadOptions()` failed.
+     */
+    bool threadOptionsApplied() const;
+
+    /**
+     * @brief Sets thread scheduling policy and priority for the signal thread.
+     *
+     * @param schedPolicy One of SCHED_FIFO, SCHED_RR, or SCHED_OTHER.
+     * @param priority Desired priority level for the thread.
+     * @return true if the change succeeded, false otherwise.
+     */
+    bool setPriority(int schedPolicy, int priority);
+
+    /**
+     * @brief Gives a set of signals a signal thread of their own.
+     *
+     * @details
+     * A single thread calling `sigwaitinfo()` saturates long before the
+     * senders do once real-time signals carry traffic. Each shard thread
+     * waits on its own signals, and every other thread has them blocked and
+     * outside its wait set, so the kernel queues each record to that shard
+     * alone. Handlers for a shard's signals run on the shard thread, never
+     * on the dispatch pool, and concurrently with other shards. Records are
+     * published to `shardEvents()`, which only that thread writes, so
+     * consumers pinned next to it read locally. The main signal thread
+     * keeps the stop signals, the timers and every signal not sharded.
+     * Records another instance forwards, and waiters, are handled by the
+     * thread that owns the signal. Not available in signalfd mode.
+     *
+     * @param signals Signals the shard owns; those not yet registered are
+     *                waited on once `registerHandler()` adds them. Must not
+     *                overlap another shard or contain a handled signal.
+     * @param options Attributes for the shard thread, as for `setThreadOptions()`.
+     * @return The shard index, or -1 if running, full or `signals` is invalid.
+     */
+    int addShard(const sigset_t &signals, const ThreadOptions &options);
+
+    /**
+     * @brief Adds a shard whose thread is pinned to one CPU.
+     *
+     * @param signals Signals the shard owns; see the other overload.
+     * @param cpu The CPU to pin the shard thread to.
+     * @return The shard index, or -1 on failure.
+     */
+    int addShard(const sigset_t &signals, int cpu);
+
+    /**
+     * @brief Returns the number of shards added with `addShard()`.
+     *
+     * @return The shard count, not counting the main signal thread.
+     */
+    std::size_t shardCount() const;
+
+    /**
+     * @brief Returns the event ring a shard thread publishes to.
+     *
+     * @param index A shard index from `addShard()`.
+     * @return The shard's ring, or `events()` if `index` is out of range.
+     */
+    const SignalEventRing &shardEvents(std::size_t index) const;
+
+    /**
+     * @brief Chooses whether and when the terminal's ECHOCTL is disabled.
+     *
+     * @details Saving the terminal costs `tcgetattr()` and `tcsetattr()` on
+     * stdin, which is wasted under systemd or in a container where stdin is
+     * /dev/null or a pipe. On a terminal in the background `tcsetattr()`
+     * raises SIGTTOU, which stops the process unless SIGTTOU is blocked or
+     * ignored. `Auto` checks `isatty()` and the foreground process group
+     * first. `Async` runs the same check and setup as the signal thread's
+     * first action, so `start()` returns right after `pthread_create()`. A
+     * `^C` typed in that window may still be echoed. In signalfd mode
+     * there is no thread, so `Async` behaves like `Auto`.
+     *
+     * @param mode The mode for the next `start()` or `startSignalFd()`.
+     * @return false if already running.
+     */
+    bool setTerminalMode(TerminalMode mode);
+
+    /**
+     * @brief Chooses how a child created with `fork()` treats this handler.
+     *
+     * @details Only the forking thread exists in the child. With `Respawn`
+     * the child gets a new signal thread, or in signalfd mode a fresh
+     * signalfd at the same descriptor number, with the pool restarted and
+     * forwarded signals dropped. The handler must be running when `fork()`
+     * is called. A fork from the signal thread itself keeps running in the
+     * child and is left as it is. With `Keep` an inherited signalfd still
+     * reads the child's own signals, but `epoll` sets created before the
+     * fork may not report it.
+     *
+     * @param mode The mode; may be changed at any time.
+     */
+    void setForkMode(ForkMode mode);
+
+    /**
+     * @brief Restores the signal mask and terminal settings for `exec()`.
+     *
+     * @details Call in the child between `fork()` and `exec()`. Sets the
+     * calling thread's mask back to what it was before `block_signals()` or
+     * the first handler blocked anything, so the new program does not
+     * inherit blocked signals. Async-signal-safe.
+     *
+     * @param restore_terminal Also restore the terminal settings. The
+     *                         terminal is shared with the parent.
+     */
+    static void prepareExec(bool restore_terminal = true);
+
+    /**
+     * @brief Converts a signal number to its string representation.
+     *
+     * @param signum The signal number to convert.
+     * @details Real-time signals are named relative to SIGRTMIN, as in
+     * `kill -l` (e.g. "SIGRTMIN+3", "SIGRTMAX").
+     *
+     * @return A string view of the signal name or "UNKNOWN" if not found.
+     */
+    static std::string_view signalToString(int signum);
+
+    /**
+     * @brief One entry of `signal_table`.
+     */
+    struct SignalEntry
+    {
+        std::string_view name; ///< Signal name, empty if unnamed.
+        bool handled;          ///< Blocked and waited on by the handler.
+        bool immediate;        ///< Requires forced shutdown.
+    };
+
+    /**
+     * @brief One past the highest signal number (`SIGRTMAX`) on this platform.
+     */
+    static constexpr int signal_limit = _NSIG;
+
+    /**
+     * @brief Dense table of signals indexed by signal number.
+     *
+     * @details Constant-initialized, so lookups are a single indexed load and
+     * there is no static-init-order dependency for global handlers.
+     */
+    static constexpr std::array<SignalEntry, signal_limit> signal_table = []() constexpr
+    {
+        std::array<SignalEntry, signal_limit> table{};
+
+        table[SIGHUP] = {"SIGHUP", true, false};
+        table[SIGINT] = {"SIGINT", true, false};
+        table[SIGQUIT] = {"SIGQUIT", true, false};
+        table[SIGILL] = {"SIGILL", true, true};
+        table[SIGTRAP] = {"SIGTRAP", false, false};
+        table[SIGABRT] = {"SIGABRT", true, true};
+        table[SIGBUS] = {"SIGBUS", true, true};
+        table[SIGFPE] = {"SIGFPE", true, true};
+        table[SIGKILL] = {"SIGKILL", false, false};
+        table[SIGUSR1] = {"SIGUSR1", false, false};
+        table[SIGSEGV] = {"SIGSEGV", true, true};
+        table[SIGUSR2] = {"SIGUSR2", false, false};
+        table[SIGPIPE] = {"SIGPIPE", false, false};
+        table[SIGALRM] = {"SIGALRM", false, false};
+        table[SIGTERM] = {"SIGTERM", true, false};
+        table[SIGCHLD] = {"SIGCHLD", false, false};
+        table[SIGCONT] = {"SIGCONT", false, false};
+        table[SIGSTOP] = {"SIGSTOP", false, false};
+        table[SIGTSTP] = {"SIGTSTP", false, false};
+        table[SIGTTIN] = {"SIGTTIN", false, false};
+        table[SIGTTOU] = {"SIGTTOU", false, false};
+        table[SIGURG] = {"SIGURG", false, false};
+        table[SIGXCPU] = {"SIGXCPU", false, false};
+        table[SIGXFSZ] = {"SIGXFSZ", false, false};
+        table[SIGVTALRM] = {"SIGVTALRM", false, false};
+        table[SIGPROF] = {"SIGPROF", false, false};
+        table[SIGWINCH] = {"SIGWINCH", false, false};
+        table[SIGIO] = {"SIGIO", false, false};
+        table[SIGPWR] = {"SIGPWR", false, false};
+        table[SIGSYS] = {"SIGSYS", false, false};
+
+        return table;
+    }();
+
+    /**
+     * @brief Bit for a signal in a 64-bit signal mask (bit `signum - 1`).
+     *
+     * @param signum A signal number in [1, signal_limit).
+     * @return The mask bit for the signal.
+     */
+    static constexpr std::uint64_t signalBit(int signum)
+    {
+        return std::uint64_t{1} << (signum - 1);
+    }
+
+    /**
+     * @brief Compile-time mask of every handled signal in `signal_table`.
+     */
+    static constexpr std::uint64_t handled_mask = []() constexpr
+    {
+        std::uint64_t mask = 0;
+        for (int sig = 1; sig < signal_limit; ++sig)
+        {
+            if (signal_table[sig].handled)
+            {
+                mask |= std::uint64_t{1} << (sig - 1); // signalBit(sig)
+            }
+        }
+        return mask;
+    }();
+
+    static_assert(signal_limit <= 65, "signal masks assume at most 64 signals");
+
+    /**
+     * @brief Maximum number of signals drained and dispatched per wakeup.
+     */
+    static constexpr std::size_t batch_capacity = 32;
+
+    /**
+     * @brief Maximum number of shards `addShard()` accepts.
+     */
+    static constexpr std::size_t max_shards = 16;
+
+private:
+    /**
+     * @brief Worker thread that runs in the signal loop.
+     */
+    pthread_t worker_thread;
+
+    /**
+     * @brief Set once `worker_thread` is valid, cleared after joining.
+     */
+    std::atomic<bool> worker_started;
+
+    /**
+     * @brief Attributes for the signal thread.
+     */
+    ThreadOptions thread_options;
+
+    /**
+     * @brief Cleared if a thread option could not be applied.
+     */
+    std::atomic<bool> options_applied;
+
+    /**
+     * @brief Indicates if the signal loop is active.
+     * */
+    std::atomic<bool> running;
+
+    /**
+     * @brief Flag used to break the signal wait loop.
+     */
+    std::atomic<bool> stop_requested;
+
+    /**
+     * @brief Suppresses callback on dummy signal during shutdown.
+     */
+    std::atomic<bool> stopping;
+
+    /**
+     * @brief User-provided signal handler callback.
+     */
+    Callback callback;
+
+    /**
+     * @brief User-provided batch callback, preferred over `callback` when set.
+     */
+    BatchCallback batch_callback;
+
+    /**
+     * @brief One registered handler; immutable while published.
+     */
+    struct HandlerSlot
+    {
+        Handler handler;
+        HandlerFlags flags = HandlerFlags::None;
+    };
+
+    /**
+     * @brief Published handler per signal, nullptr if none.
+     */
+    std::array<std::atomic<HandlerSlot *>, signal_limit> handler_slots;
+
+    /**
+     * @brief `DispatchPolicy` per signal.
+     */
+    std::array<std::atomic<std::uint8_t>, signal_limit> dispatch_policies;
+
+    /**
+     * @brief Per-signal throttle policies and held records.
+     */
+    SignalThrottle signal_throttle;
+
+    /**
+     * @brief Workers for non-inline policies.
+     */
+    SignalDispatchPool dispatch_pool;
+
+    /**
+     * @brief RCU reader slot per pool worker.
+     */
+    std::array<int, SignalDispatchPool::max_workers> pool_readers;
+
+    /**
+     * @brief Next worker for `Pooled` deliveries; dispatching thread only.
+     */
+    std::size_t pool_cursor;
+
+    /**
+     * @brief Two preallocated slots per signal, alternated on each update.
+     */
+    std::array<std::array<HandlerSlot, 2>, signal_limit> slot_storage;
+
+    /**
+     * @brief Serializes handler registration (never taken to dispatch).
+     *
+     * @details Never held across an RCU grace period, so a handler on the
+     * signal thread may take it through `watchSignal()`.
+     */
+    std::mutex registry_mutex;
+
+    /**
+     * @brief Serializes handler updates across their grace period.
+     *
+     * @details Held by `registerHandler()` and `unregisterHandler()` until
+     * the old slot is released, so the next update of the same signal never
+     * refills a slot a dispatch may still be reading. Taken before
+     * `registry_mutex`, and never by the dispatching thread.
+     */
+    std::mutex update_mutex;
+
+    /**
+     * @brief Mask of signals currently waited on (`signalBit()` layout).
+     */
+    std::atomic<std::uint64_t> active_mask;
+
+    /**
+     * @brief Lock-free stack of pending `addWaiter()` requests.
+     */
+    std::atomic<SignalWaiter *> waiters;
+
+    /**
+     * @brief Serializes `completeWaiters()` between the main thread and shards.
+     *
+     * @details Completion detaches the whole stack, so a second completer
+     * running meanwhile would find it empty and miss its waiters.
+     */
+    std::mutex waiters_mutex;
+
+    /**
+     * @brief Protects `handler_slots` readers from concurrent replacement.
+     */
+    SignalRcu rcu;
+
+    /**
+     * @brief RCU reader slot of the dispatching thread, -1 if none.
+     */
+    int rcu_reader;
+
+    /**
+     * @brief Broadcast ring fed by the dispatching thread.
+     */
+    SignalEventRing event_ring;
+
+    /**
+     * @brief Stop source behind `getStopToken()`.
+     */
+    SignalStopSource stop_source;
+
+    /**
+     * @brief Set by the first stop signal; a later one escalates.
+     *
+     * @details Kept apart from the coordinator's own state, which
+     * `requestStop()` from a woken thread may have claimed first.
+     */
+    std::atomic<bool> stop_signalled{false};
+
+    /**
+     * @brief Phased shutdown run when a stop is requested.
+     */
+    SignalShutdown shutdown_coordinator;
+
+    /**
+     * @brief Dispatch counters and latency histograms behind `stats()`.
+     */
+    SignalMetrics metrics;
+
+    /**
+     * @brief Optional shared-memory record of dispatched signals.
+     */
+    SignalEventLog event_log;
+
+    /**
+     * @brief Kernel thread ID of the dispatching thread, for log records.
+     */
+    int dispatch_tid;
+
+    /**
+     * @brief Exit handlers and batched reaping for child processes.
+     */
+    SignalChildReaper child_reaper;
+
+    /**
+     * @brief Heartbeat slots scanned on each watchdog tick.
+     */
+    SignalWatchdog thread_watchdog;
+
+    /**
+     * @brief Watchdog tick interval in milliseconds, 0 if disabled.
+     */
+    std::atomic<std::int64_t> watchdog_interval_ms;
+
+    /**
+     * @brief Sampling profiler started by the `enableProfiler()` trigger.
+     */
+    SignalProfiler sampling_profiler;
+
+    /**
+     * @brief Where `finishProfile()` writes folded stacks.
+     */
+    std::string profile_path;
+
+    /**
+     * @brief Sampling window set by `enableProfiler()`.
+     */
+    std::chrono::milliseconds profile_window;
+
+    /**
+     * @brief Sampling rate set by `enableProfiler()`.
+     */
+    int profile_hz;
+
+    /**
+     * @brief Sections and writer behind `enableStateDump()`.
+     */
+    SignalStateDump state_dump;
+
+    /**
+     * @brief Where `enableStateDump()` appends dumps.
+     */
+    std::string dump_path;
+
+    /**
+     * @brief Slot in `SignalRegistry`, -1 while not running.
+     */
+    int registry_slot;
+
+    /**
+     * @brief Signals blocked by `registerHandler()` before `start()`.
+     * @details Handed to the registry so they are unblocked again at the end.
+     */
+    std::uint64_t preblocked_mask;
+
+    /**
+     * @brief Signals forwarded by other instances, awaiting dispatch.
+     */
+    std::vector<siginfo_t> inbox;
+
+    /**
+     * @brief Protects `inbox`.
+     */
+    std::mutex inbox_mutex;
+
+    /**
+     * @brief Set when `inbox` may be non-empty.
+     */
+    std::atomic<bool> inbox_pending;
+
+    /**
+     * @brief Set of signals to wait on (copied from `handledSignals()`).
+     */
+    sigset_t signal_set;
+
+    /**
+     * @brief Descriptor returned by `startSignalFd()`, -1 in thread mode.
+     */
+    int signal_fd;
+
+    /**
+     * @brief The `ForkMode` applied by `afterFork()`.
+     */
+    std::atomic<ForkMode> fork_mode;
+
+    /**
+     * @brief The `TerminalMode` set by `setTerminalMode()`.
+     */
+    TerminalMode terminal_mode;
+
+    /**
+     * @brief A signal thread that owns a subset of the wait set.
+     */
+    struct Shard
+    {
+        SignalHandler *owner = nullptr;   ///< For the pthread entry point.
+        std::uint64_t mask = 0;           ///< Signals the shard owns.
+        ThreadOptions options;            ///< Attributes for its thread.
+        pthread_t thread{};               ///< The thread, valid if `started`.
+        std::atomic<bool> started{false}; ///< Set once `thread` is valid.
+        int reader = -1;                  ///< The thread's RCU reader slot.
+        int tid = 0;                      ///< Kernel thread id, for throttle ticks.
+        SignalEventRing events;           ///< Published by the shard thread only.
+        std::vector<siginfo_t> inbox;     ///< Its signals forwarded by other instances.
+        std::mutex inbox_mutex;           ///< Protects `inbox`.
+        std::atomic<bool> inbox_pending{false}; ///< Set when `inbox` may be non-empty.
+    };
+
+    /**
+     * @brief Shards added with `addShard()`; fixed once running.
+     */
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    /**
+     * @brief Union of every shard's `mask`, left out of the main wait set.
+     */
+    std::uint64_t shard_mask;
+
+    /**
+     * @brief Subscribes to `SignalRegistry`, which blocks the signal set, and
+     *        applies the terminal mode.
+     * @details Shared setup for `start()` and `startSignalFd()`.
+     *
+     * @param defer_terminal Leave the terminal to `applyTerminalMode()` on
+     *                       the signal thread.
+     * @return true if the handler is ready to wait, false if the registry is full.
+     */
+    bool prepare(bool defer_terminal);
+
+    /**
+     * @brief Takes a terminal reference if `terminal_mode` allows it.
+     */
+    void applyTerminalMode();
+
+    /**
+     * @brief Leaves `SignalRegistry` and drops undelivered forwarded signals.
+     */
+    void release();
+
+    /**
+     * @brief Drains and joins the dispatch pool and frees its RCU slots.
+     */
+    void stopPool();
+
+    /**
+     * @brief Queues a signal another instance received; called by `SignalRegistry`.
+     *
+     * @param info The signal.
+     */
+    void forward(const siginfo_t &info);
+
+    /**
+     * @brief Recovers the handler in a forked child; called by `SignalRegistry`.
+     */
+    void afterFork();
+
+    /**
+     * @brief Creates the signal thread with `thread_options`.
+     *
+     * @return true if the thread was created.
+     */
+    bool spawnWorker();
+
+    /**
+     * @brief Creates a thread with every signal blocked and `options` applied.
+     *
+     * @param thread Receives the thread.
+     * @param options Placement, policy, stack size.
+     * @param entry The thread's entry point.
+     * @param arg Argument for `entry`.
+     * @return true if the thread was created.
+     */
+    bool spawnThread(pthread_t &thread, const ThreadOptions &options, void *(*entry)(void *),
+                     void *arg);
+
+    /**
+     * @brief Creates a shard's thread.
+     *
+     * @param shard The shard.
+     * @return true if the thread was created.
+     */
+    bool spawnShard(Shard &shard);
+
+    /**
+     * @brief Wakes the shard threads that own any of `bits`.
+     *
+     * @param bits Signals in `signalBit()` layout.
+     */
+    void wakeShards(std::uint64_t bits);
+
+    /**
+     * @brief Wakes and joins every shard thread.
+     */
+    void joinShards();
+
+    /**
+     * @brief Forgets shard threads lost in a fork and optionally respawns them.
+     *
+     * @param respawn Start new shard threads in the child.
+     */
+    void shardsAfterFork(bool respawn);
+
+    /**
+     * @brief Arms the watchdog timer at the dispatching thread, if enabled.
+     */
+    void armWatchdog();
+
+    /**
+     * @brief Ends the profiling window and writes it to `profile_path`.
+     */
+    void finishProfile();
+
+    /**
+     * @brief Dispatches forwarded signals on the dispatching thread.
+     *
+     * @param shard The shard whose inbox to drain, or nullptr for the main one.
+     * @return The number delivered, as counted by `dispatchBatch()`.
+     */
+    std::size_t drainInbox(Shard *shard = nullptr);
+
+    /**
+     * @brief Queues a delivery on the pool according to its policy.
+     *
+     * @param info The signal.
+     * @param woke_ns When the dispatching thread woke.
+     * @return true if queued, false if it must run inline.
+     */
+    bool deferDelivery(const siginfo_t &info, std::int64_t woke_ns);
+
+    /**
+     * @brief Runs a queued delivery on a pool worker.
+     *
+     * @param self The SignalHandler.
+     * @param worker The worker index.
+     * @param job The delivery.
+     */
+    static void runDeferred(void *self, std::size_t worker, const SignalDispatchPool::Job &job);
+
+    /**
+     * @brief Routes a single received signal to the callback.
+     *
+     * @param info The signal information received.
+     */
+    void dispatch(const siginfo_t &info);
+
+    /**
+     * @brief Filters a drained batch and hands it to the callback(s).
+     *
+     * @param records Records drained in one wakeup; compacted in place.
+     * @param count Number of valid records.
+     * @param woke_ns Monotonic timestamp taken when the wait returned.
+     * @param forwarded true for records from `drainInbox()`, which are not
+     *                  fanned out again.
+     * @param shard The shard dispatching, or nullptr for the main thread.
+     * @return The number of records delivered to a handler, waiter or
+     *         callback; wake-ups, ticks and filtered records are not counted.
+     */
+    std::size_t dispatchBatch(siginfo_t *records, std::size_t count, std::int64_t woke_ns,
+                              bool forwarded = false, Shard *shard = nullptr);
+
+    /**
+     * @brief Adds a signal to `active_mask` and the live wait set.
+     *
+     * @param signum The signal number.
+     * @note Called with `registry_mutex` held.
+     */
+    void addToWaitSet(int signum);
+
+    /**
+     * @brief Pushes a chain of waiters onto `waiters`.
+     *
+     * @param first Head of the chain.
+     * @param last Tail of the chain.
+     */
+    void pushWaiters(SignalWaiter *first, SignalWaiter *last);
+
+    /**
+     * @brief Completes every waiter whose mask includes a signal.
+     *
+     * @param info The dispatched signal.
+     * @return true if at least one waiter was completed.
+     */
+    bool completeWaiters(const siginfo_t &info);
+
+    /**
+     * @brief Completes every queued waiter with an empty `siginfo_t`.
+     */
+    void cancelWaiters();
+
+    /**
+     * @brief Handles a graceful-stop signal.
+     *
+     * @details Triggers the stop token and begins the shutdown coordinator;
+     * if the coordinator is already running, escalates it instead.
+     */
+    void onStopSignal();
+
+    /**
+     * @brief Signals to block and wait on right now.
+     *
+     * @return `active_mask`, minus the fault signals if the crash path owns them.
+     */
+    std::uint64_t waitMask() const;
+
+    /**
+     * @brief Sends the internal wake-up signal to the signal thread.
+     */
+    void wake();
+
+    /**
+     * @brief pthread entry point; names the thread, then calls `run()`.
+     *
+     * @param self The SignalHandler.
+     * @return nullptr.
+     */
+    static void *threadMain(void *self);
+
+    /**
+     * @brief Internal function run by the signal handling thread.
+     * @details Waits on blocked signals and triggers callbacks or exits.
+     */
+    void run();
+
+    /**
+     * @brief pthread entry point for a shard thread.
+     *
+     * @param shard The Shard.
+     * @return nullptr.
+     */
+    static void *shardMain(void *shard);
+
+    /**
+     * @brief Signal loop of a shard thread.
+     *
+     * @param shard The shard.
+     */
+    void runShard(Shard &shard);
+};
+
+/**
+ * @brief Combines handler flags.
+ */
+constexpr SignalHandler::HandlerFlags operator|(SignalHandler::HandlerFlags a,
+                                                SignalHandler::HandlerFlags b)
+{
+    return static_cast<SignalHandler::HandlerFlags>(static_cast<unsigned>(a) |
+                                                    static_cast<unsigned>(b));
+}
+
+/**
+ * @brief Tests handler flags.
+ */
+constexpr bool operator&(SignalHandler::HandlerFlags a, SignalHandler::HandlerFlags b)
+{
+    return (static_cast<unsigned>(a) & static_cast<unsigned>(b)) != 0;
+}
+
+#ifdef __cpp_impl_coroutine
+#include "signal_coro.hpp"
+#endif
 
 #endif // SIGNAL_HANDLER_HPP
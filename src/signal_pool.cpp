@@ -0,0 +1,262 @@
+/**
+ * @file signal_pool.cpp
+ * @brief Bounded worker pool that runs signal handlers off the signal thread.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_pool.hpp"
+
+// Standard libraries
+#include <climits>
+#include <new>
+
+// System libraries
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Private futex call on a 32-bit atomic.
+ *
+ * @param word The atomic to wait on or wake.
+ * @param op FUTEX_WAIT_PRIVATE or FUTEX_WAKE_PRIVATE.
+ * @param val Expected value for a wait, or the number of waiters to wake.
+ * @return The raw syscall result.
+ */
+static long futex(const std::atomic<std::uint32_t> *word, int op, std::uint32_t val)
+{
+    return syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(word),
+                   op, val, nullptr, nullptr, 0);
+}
+
+/**
+ * @brief Destructor; drains and joins any running workers.
+ */
+SignalDispatchPool::~SignalDispatchPool()
+{
+    stop();
+}
+
+/**
+ * @brief Allocates the queues and starts the workers.
+ *
+ * @details Workers inherit a fully blocked signal mask, so no signal is
+ * ever delivered to them asynchronously.
+ *
+ * @param threads Number of workers.
+ * @param capacity Jobs per queue.
+ * @param run Executes each job.
+ * @param ctx Passed to `run`.
+ * @return `true` if started.
+ */
+bool SignalDispatchPool::start(std::size_t threads, std::size_t capacity, Runner run, void *ctx)
+{
+    if (active.load() != 0 || threads == 0 || threads > max_workers || capacity == 0 ||
+        run == nullptr)
+    {
+        return false;
+    }
+
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    mask = size - 1;
+    runner = run;
+    context = ctx;
+    stopping.store(false);
+
+    workers.clear();
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(new Worker());
+        workers.back()->ring.resize(size);
+    }
+
+    sigset_t all;
+    sigset_t previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers[i]->thread = std::thread([this, i]
+                                         { work(i); });
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+    active.store(threads, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Queues a job on one worker.
+ *
+ * @details
+ * Single producer: only the dispatching thread calls this. The job is
+ * published with a release store of `tail`. The `submitted` bump and the
+ * `sleeping` check pair with the worker's store-then-recheck, so a worker
+ * going to sleep either sees the job or is woken.
+ *
+ * @param worker The worker.
+ * @param info The signal.
+ * @param woke_ns When the dispatching thread woke.
+ * @return `true` if queued.
+ */
+bool SignalDispatchPool::submit(std::size_t worker, const siginfo_t &info,
+                                std::int64_t woke_ns) noexcept
+{
+    if (worker >= active.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    Worker &w = *workers[worker];
+    std::size_t tail = w.tail.load(std::memory_order_relaxed);
+    if (tail - w.head.load(std::memory_order_acquire) > mask)
+    {
+        return false; // Full
+    }
+
+    Job &job = w.ring[tail & mask];
+    job.info = info;
+    job.woke_ns = woke_ns;
+    w.tail.store(tail + 1, std::memory_order_release);
+
+    w.submitted.fetch_add(1);
+    if (w.sleeping.load())
+    {
+        futex(&w.submitted, FUTEX_WAKE_PRIVATE, 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Drains every queue and joins the workers.
+ */
+void SignalDispatchPool::stop()
+{
+    if (active.exchange(0) == 0)
+    {
+        return;
+    }
+
+    stopping.store(true);
+    for (auto &w : workers)
+    {
+        w->submitted.fetch_add(1);
+        futex(&w->submitted, FUTEX_WAKE_PRIVATE, 1);
+    }
+    for (auto &w : workers)
+    {
+        if (w->thread.joinable())
+        {
+            w->thread.join();
+        }
+    }
+}
+
+/**
+ * @brief Recovers the pool in a forked child.
+ *
+ * @param restart Start new workers.
+ * @return `true` if running afterwards.
+ */
+bool SignalDispatchPool::afterFork(bool restart)
+{
+    std::size_t count = active.exchange(0);
+    if (count == 0)
+    {
+        return false;
+    }
+
+    for (auto &w : workers)
+    {
+        // Joining or destroying a joinable handle would never return or abort
+        new (&w->thread) std::thread();
+    }
+
+    if (!restart)
+    {
+        return false;
+    }
+    return start(count, mask + 1, runner, context);
+}
+
+/**
+ * @brief Reports whether the workers are running.
+ *
+ * @return `true` if started and not stopped.
+ */
+bool SignalDispatchPool::running() const noexcept
+{
+    return active.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * @brief Returns the number of workers.
+ *
+ * @return The worker count.
+ */
+std::size_t SignalDispatchPool::size() const noexcept
+{
+    return active.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Worker loop.
+ *
+ * @param index The worker.
+ */
+void SignalDispatchPool::work(std::size_t index)
+{
+    Worker &w = *workers[index];
+    while (true)
+    {
+        std::size_t head = w.head.load(std::memory_order_relaxed);
+        if (head != w.tail.load(std::memory_order_acquire))
+        {
+            runner(context, index, w.ring[head & mask]);
+            w.head.store(head + 1, std::memory_order_release);
+            continue;
+        }
+
+        if (stopping.load())
+        {
+            return; // Queue drained
+        }
+
+        // Announce the sleep, then re-check so a racing submit is not missed
+        w.sleeping.store(true);
+        std::uint32_t seen = w.submitted.load();
+        if (head == w.tail.load() && !stopping.load())
+        {
+            futex(&w.submitted, FUTEX_WAIT_PRIVATE, seen);
+        }
+        w.sleeping.store(false);
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file signal_pool.hpp
+ * @brief Bounded worker pool that runs signal handlers off the signal thread.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_POOL_HPP
+#define SIGNAL_POOL_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs dispatched signals on a few worker threads.
+ *
+ * @details
+ * Each worker owns a preallocated single-producer, single-consumer ring.
+ * The dispatching thread is the only producer, so `submit()` is two
+ * atomic loads, a copy into the ring and one release store, plus a futex
+ * wake only if that worker is asleep. Nothing is allocated after `start()`.
+ *
+ * Jobs for the same worker run in submission order. Sending every record
+ * of a signal to the same worker therefore serializes that signal's
+ * handlers, while different signals still run in parallel.
+ *
+ * Workers are created with every signal blocked. `stop()` lets each worker
+ * finish its queue before joining it.
+ */
+class SignalDispatchPool
+{
+public:
+    /**
+     * @brief One queued delivery.
+     */
+    struct Job
+    {
+        siginfo_t info;        ///< The signal.
+        std::int64_t woke_ns;  ///< When the dispatching thread woke, for latency stats.
+    };
+
+    /**
+     * @brief Executes a job on worker `worker`.
+     */
+    using Runner = void (*)(void *context, std::size_t worker, const Job &job);
+
+    /**
+     * @brief Maximum number of worker threads.
+     */
+    static constexpr std::size_t max_workers = 16;
+
+    SignalDispatchPool() = default;
+    ~SignalDispatchPool();
+
+    // Workers refer to this object
+    SignalDispatchPool(const SignalDispatchPool &) = delete;
+    SignalDispatchPool &operator=(const SignalDispatchPool &) = delete;
+
+    /**
+     * @brief Allocates the queues and starts the workers.
+     *
+     * @param threads Number of workers, 1 to `max_workers`.
+     * @param capacity Jobs per worker queue, rounded up to a power of two.
+     * @param runner Called on a worker for each job.
+     * @param context Passed to `runner`.
+     * @return false if already running or the arguments are invalid.
+     */
+    bool start(std::size_t threads, std::size_t capacity, Runner runner, void *context);
+
+    /**
+     * @brief Queues a job on one worker; dispatching thread only.
+     *
+     * @param worker The worker index, below `size()`.
+     * @param info The signal.
+     * @param woke_ns When the dispatching thread woke.
+     * @return false if that worker's queue is full or the pool is stopped.
+     */
+    bool submit(std::size_t worker, const siginfo_t &info, std::int64_t woke_ns) noexcept;
+
+    /**
+     * @brief Drains every queue and joins the workers.
+     */
+    void stop();
+
+    /**
+     * @brief Recovers the pool in a child after `fork()`.
+     *
+     * @details None of the workers exist in the child. Their threads are
+     * forgotten without joining, any queued jobs are dropped, and with
+     * `restart` as many fresh workers are started on new queues.
+     *
+     * @param restart Start new workers rather than leave the pool stopped.
+     * @return true if the pool is running afterwards.
+     */
+    bool afterFork(bool restart);
+
+    /**
+     * @brief Reports whether the workers are running.
+     *
+     * @return true between `start()` and `stop()`.
+     */
+    bool running() const noexcept;
+
+    /**
+     * @brief Returns the number of workers.
+     *
+     * @return The worker count, 0 when stopped.
+     */
+    std::size_t size() const noexcept;
+
+private:
+    /**
+     * @brief A worker's queue and sleep state.
+     */
+    struct Worker
+    {
+        alignas(64) std::atomic<std::size_t> head{0};         ///< Next job to run (consumer).
+        alignas(64) std::atomic<std::size_t> tail{0};         ///< Next free slot (producer).
+        alignas(64) std::atomic<std::uint32_t> submitted{0};  ///< Futex word, bumped per job.
+        std::atomic<bool> sleeping{false};                    ///< Set while in futex wait.
+        std::vector<Job> ring;                                ///< Preallocated jobs.
+        std::thread thread;                                   ///< The worker thread.
+    };
+
+    /**
+     * @brief Worker loop: run queued jobs, sleep when empty.
+     *
+     * @param index The worker.
+     */
+    void work(std::size_t index);
+
+    /**
+     * @brief The workers; allocated by `start()`.
+     */
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /**
+     * @brief Ring index mask (capacity - 1).
+     */
+    std::size_t mask = 0;
+
+    /**
+     * @brief Job executor.
+     */
+    Runner runner = nullptr;
+
+    /**
+     * @brief Context for `runner`.
+     */
+    void *context = nullptr;
+
+    /**
+     * @brief Number of started workers.
+     */
+    std::atomic<std::size_t> active{0};
+
+    /**
+     * @brief Set by `stop()`; workers exit once their queue is empty.
+     */
+    std::atomic<bool> stopping{false};
+};
+
+#endif // SIGNAL_POOL_HPP
@@ -0,0 +1,564 @@
+/**
+ * @file signal_profiler.cpp
+ * @brief On-demand SIGPROF sampling profiler with folded-stack output.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_profiler.hpp"
+
+// Standard libraries
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+
+// System libraries
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// Older C libraries only expose the union member
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/**
+ * @brief Frames at the top of each sample that belong to the handler itself.
+ *
+ * @details `onProfSignal()` and the kernel's signal return trampoline.
+ */
+static constexpr int handler_frames = 2;
+
+/**
+ * @brief The profiler currently sampling, nullptr if none.
+ */
+static std::atomic<SignalProfiler *> active_profiler{nullptr};
+
+/**
+ * @brief Number of SIGPROF handlers currently running.
+ */
+static std::atomic<int> handlers_running{0};
+
+/**
+ * @brief The calling thread's ring in the active profiler, -1 if none.
+ */
+static thread_local int ring_index = -1;
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ *
+ * @return The current time.
+ */
+static std::int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Converts nanoseconds to a timespec.
+ *
+ * @param ns The duration.
+ * @return The timespec.
+ */
+static timespec toTimespec(std::int64_t ns)
+{
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    return ts;
+}
+
+/**
+ * @brief Names the function containing an address.
+ *
+ * @details Uses the dynamic symbol table, so names need `-rdynamic` (or a
+ * shared library); otherwise the frame is written as `module+0xoffset`,
+ * which `addr2line` resolves offline.
+ *
+ * @param addr A return address.
+ * @return The demangled name, `module+0xoffset`, or the raw address.
+ */
+static std::string symbolize(void *addr)
+{
+    // A return address may already be past the end of the calling function
+    void *lookup = static_cast<char *>(addr) - 1;
+    char buffer[64];
+
+    Dl_info info;
+    if (dladdr(lookup, &info) != 0)
+    {
+        if (info.dli_sname != nullptr)
+        {
+            int status = 0;
+            char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+            std::free(demangled);
+            return name;
+        }
+        if (info.dli_fname != nullptr)
+        {
+            const char *base = std::strrchr(info.dli_fname, '/');
+            std::snprintf(buffer, sizeof(buffer), "+0x%lx",
+                          static_cast<unsigned long>(static_cast<char *>(addr) -
+                                                     static_cast<char *>(info.dli_fbase)));
+            return std::string(base != nullptr ? base + 1 : info.dli_fname) + buffer;
+        }
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "0x%lx",
+                  static_cast<unsigned long>(reinterpret_cast<std::uintptr_t>(addr)));
+    return buffer;
+}
+
+/**
+ * @brief Writes a whole buffer, retrying short writes.
+ *
+ * @param fd The descriptor.
+ * @param data The bytes.
+ * @return `true` if everything was written.
+ */
+static bool writeAll(int fd, const std::string &data)
+{
+    std::size_t done = 0;
+    while (done < data.size())
+    {
+        ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return false;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs an idle profiler; rings are allocated on first use.
+ */
+SignalProfiler::SignalProfiler()
+    : timer(),
+      timer_armed(false),
+      running(false),
+      deadline_ns(0),
+      sample_count(0),
+      drop_count(0)
+{
+}
+
+/**
+ * @brief Destructor; stops a running window without writing it.
+ */
+SignalProfiler::~SignalProfiler()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running.load())
+    {
+        stopTimers();
+    }
+}
+
+/**
+ * @brief Starts a profiling window.
+ *
+ * @details
+ * - Claims the process-wide sampling role.
+ * - Clears the rings and the aggregate from the last window.
+ * - Installs `onProfSignal()` for SIGPROF, unless something else owns it,
+ *   and calls `backtrace()` once so libgcc is loaded before signal context.
+ * - Arms the collection timer at `tid`, then `ITIMER_PROF`.
+ *
+ * @param window How long to sample.
+ * @param hz Samples per second of CPU time, 1 to 1000.
+ * @param tick_signo The collection tick signal.
+ * @param tid The collecting thread.
+ * @return `true` if sampling started.
+ */
+bool SignalProfiler::begin(std::chrono::milliseconds window, int hz, int tick_signo, pid_t tid)
+{
+    if (window <= std::chrono::milliseconds::zero() || hz <= 0 || hz > 1000 || tid <= 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running.load())
+    {
+        return false;
+    }
+
+    SignalProfiler *expected = nullptr;
+    if (!active_profiler.compare_exchange_strong(expected, this))
+    {
+        return false;
+    }
+
+    struct sigaction current;
+    sigaction(SIGPROF, nullptr, &current);
+    bool ours = (current.sa_flags & SA_SIGINFO) != 0 &&
+                current.sa_sigaction == &SignalProfiler::onProfSignal;
+    if (!ours && current.sa_handler != SIG_DFL && current.sa_handler != SIG_IGN)
+    {
+        // Another profiler is installed
+        active_profiler.store(nullptr);
+        return false;
+    }
+
+    if (!rings)
+    {
+        rings.reset(new std::array<Ring, max_threads>());
+    }
+    for (Ring &ring : *rings)
+    {
+        ring.owner.store(0, std::memory_order_relaxed);
+        ring.head.store(0, std::memory_order_relaxed);
+        ring.tail.store(0, std::memory_order_relaxed);
+    }
+    stacks.clear();
+    sample_count.store(0);
+    drop_count.store(0);
+
+    void *warmup[2];
+    backtrace(warmup, 2);
+
+    if (!ours)
+    {
+        struct sigaction sa;
+        std::memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = &SignalProfiler::onProfSignal;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGPROF, &sa, nullptr);
+    }
+
+    sigevent sev;
+    std::memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = tick_signo;
+    sev.sigev_value.sival_ptr = this;
+    sev.sigev_notify_thread_id = tid;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timer) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_create");
+#endif
+        active_profiler.store(nullptr);
+        return false;
+    }
+    timer_armed = true;
+
+    std::int64_t window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+    std::int64_t collect_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(collect_interval).count();
+    if (collect_ns > window_ns)
+    {
+        collect_ns = window_ns;
+    }
+    itimerspec tick;
+    tick.it_interval = toTimespec(collect_ns);
+    tick.it_value = tick.it_interval;
+    timer_settime(timer, 0, &tick, nullptr);
+
+    deadline_ns = monotonicNs() + window_ns;
+    running.store(true, std::memory_order_release);
+
+    itimerval prof;
+    prof.it_interval.tv_sec = hz == 1 ? 1 : 0;
+    prof.it_interval.tv_usec = hz == 1 ? 0 : 1000000 / hz;
+    prof.it_value = prof.it_interval;
+    if (setitimer(ITIMER_PROF, &prof, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("setitimer");
+#endif
+        stopTimers();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reports whether a window is running.
+ *
+ * @return `true` while sampling.
+ */
+bool SignalProfiler::active() const noexcept
+{
+    return running.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Drains the rings and checks the window.
+ *
+ * @return `true` once the window has ended.
+ */
+bool SignalProfiler::onTick()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running.load())
+    {
+        return false;
+    }
+
+    drain();
+    return monotonicNs() >= deadline_ns;
+}
+
+/**
+ * @brief Stops sampling and writes the folded stacks.
+ *
+ * @details Each distinct address is symbolized once. Frames are written
+ * root first, without the handler's own frames, one stack per line
+ * followed by its sample count.
+ *
+ * @param fd The output descriptor.
+ * @return The number of stacks written, or -1 if no window was running.
+ */
+long SignalProfiler::finish(int fd)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running.load())
+    {
+        return -1;
+    }
+
+    stopTimers();
+    drain();
+
+    std::map<void *, std::string> names;
+    std::string out;
+    long written = 0;
+    for (const auto &entry : stacks)
+    {
+        const std::vector<void *> &frames = entry.first;
+        if (frames.size() <= static_cast<std::size_t>(handler_frames))
+        {
+            continue;
+        }
+
+        std::string line;
+        for (std::size_t i = frames.size(); i-- > static_cast<std::size_t>(handler_frames);)
+        {
+            auto it = names.find(frames[i]);
+            if (it == names.end())
+            {
+                it = names.emplace(frames[i], symbolize(frames[i])).first;
+            }
+            if (!line.empty())
+            {
+                line += ';';
+            }
+            line += it->second;
+        }
+        out += line;
+        out += ' ';
+        out += std::to_string(entry.second);
+        out += '\n';
+        ++written;
+
+        if (out.size() >= 64 * 1024)
+        {
+            writeAll(fd, out);
+            out.clear();
+        }
+    }
+    writeAll(fd, out);
+    return written;
+}
+
+/**
+ * @brief Returns the samples aggregated in the current or last window.
+ *
+ * @return The sample count.
+ */
+std::uint64_t SignalProfiler::samples() const noexcept
+{
+    return sample_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the samples dropped in the current or last window.
+ *
+ * @return The drop count.
+ */
+std::uint64_t SignalProfiler::dropped() const noexcept
+{
+    return drop_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Abandons a window in a forked child.
+ */
+void SignalProfiler::afterFork()
+{
+    // A thread that held it at the fork is gone
+    new (&mutex) std::mutex();
+
+    if (running.exchange(false))
+    {
+        timer_armed = false;
+        SignalProfiler *self = this;
+        active_profiler.compare_exchange_strong(self, nullptr);
+    }
+}
+
+/**
+ * @brief Moves every buffered sample into the aggregate.
+ */
+void SignalProfiler::drain()
+{
+    std::vector<void *> key;
+    for (Ring &ring : *rings)
+    {
+        if (ring.owner.load(std::memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+
+        std::size_t head = ring.head.load(std::memory_order_relaxed);
+        std::size_t tail = ring.tail.load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            const Sample &sample = ring.samples[head % ring_capacity];
+            key.assign(sample.frames, sample.frames + sample.depth);
+            ++stacks[key];
+        }
+        sample_count.fetch_add(tail - ring.head.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+        ring.head.store(tail, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Stops both timers and waits for running handlers.
+ *
+ * @details The SIGPROF handler stays installed: a signal already pending
+ * would otherwise take the default action and terminate the process.
+ */
+void SignalProfiler::stopTimers()
+{
+    itimerval off;
+    std::memset(&off, 0, sizeof(off));
+    setitimer(ITIMER_PROF, &off, nullptr);
+
+    if (timer_armed)
+    {
+        timer_delete(timer);
+        timer_armed = false;
+    }
+
+    running.store(false, std::memory_order_release);
+    SignalProfiler *self = this;
+    active_profiler.compare_exchange_strong(self, nullptr);
+
+    // A handler that loaded this profiler may still be writing a ring
+    while (handlers_running.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Records the interrupted thread's stack.
+ *
+ * @details
+ * Async-signal-safe once `backtrace()` has been warmed up. The thread's
+ * ring index is cached in a thread-local and revalidated against the
+ * ring's owner, since rings are reassigned every window. A thread that
+ * finds no free ring, or a full one, counts a drop. `errno` is preserved.
+ *
+ * @param sig SIGPROF.
+ * @param info Unused.
+ * @param context Unused.
+ */
+void SignalProfiler::onProfSignal(int sig, siginfo_t *info, void *context)
+{
+    (void)sig;
+    (void)info;
+    (void)context;
+
+    int saved_errno = errno;
+    handlers_running.fetch_add(1);
+
+    // Ordered after the increment, which stopTimers() waits on
+    SignalProfiler *profiler = active_profiler.load();
+    if (profiler != nullptr && profiler->running.load(std::memory_order_acquire))
+    {
+        auto &rings = *profiler->rings;
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+        int index = ring_index;
+        if (index < 0 || rings[index].owner.load(std::memory_order_relaxed) != tid)
+        {
+            index = -1;
+            for (std::size_t i = 0; i < max_threads; ++i)
+            {
+                pid_t expected = 0;
+                if (rings[i].owner.compare_exchange_strong(expected, tid))
+                {
+                    index = static_cast<int>(i);
+                    break;
+                }
+            }
+            ring_index = index;
+        }
+
+        if (index < 0)
+        {
+            profiler->drop_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            Ring &ring = rings[index];
+            std::size_t tail = ring.tail.load(std::memory_order_relaxed);
+            if (tail - ring.head.load(std::memory_order_acquire) >= ring_capacity)
+            {
+                profiler->drop_count.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                Sample &sample = ring.samples[tail % ring_capacity];
+                sample.depth = backtrace(sample.frames, max_frames);
+                ring.tail.store(tail + 1, std::memory_order_release);
+            }
+        }
+    }
+
+    handlers_running.fetch_sub(1);
+    errno = saved_errno;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file signal_profiler.hpp
+ * @brief On-demand SIGPROF sampling profiler with folded-stack output.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_PROFILER_HPP
+#define SIGNAL_PROFILER_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// System libraries
+#include <sys/types.h>
+#include <time.h>
+
+/**
+ * @brief A sampling CPU profiler driven by `ITIMER_PROF`.
+ *
+ * @details
+ * `begin()` installs a SIGPROF `sigaction()` handler and arms
+ * `setitimer(ITIMER_PROF)`. The kernel then sends SIGPROF at the requested
+ * rate of process CPU time, to whichever thread was running. The handler
+ * captures that thread's stack with `backtrace()` into the thread's own
+ * single-producer ring. A thread claims a ring the first time it is
+ * sampled, with one compare-and-swap on the ring's owner, so the handler
+ * never locks or allocates.
+ *
+ * A second timer (`timer_create()` with `SIGEV_THREAD_ID`) ticks one
+ * collecting thread, the SignalHandler's dispatching thread when started
+ * through `SignalHandler::enableProfiler()`. Each tick drains every ring
+ * into an aggregate keyed by stack. When the window ends, `finish()` stops
+ * both timers, symbolizes each distinct address once and writes one line
+ * per stack in the folded format read by `flamegraph.pl` and speedscope:
+ * `root;caller;leaf count`.
+ *
+ * Threads with SIGPROF blocked are never sampled. `block_signals()` leaves
+ * it unblocked, while the signal thread and pool workers block everything
+ * and so stay out of the profile. SIGPROF and `ITIMER_PROF` are
+ * process-wide, so only one profiler can sample at a time.
+ */
+class SignalProfiler
+{
+public:
+    /**
+     * @brief Maximum number of threads sampled in one window.
+     */
+    static constexpr std::size_t max_threads = 64;
+
+    /**
+     * @brief Samples buffered per thread between collections.
+     */
+    static constexpr std::size_t ring_capacity = 128;
+
+    /**
+     * @brief Maximum frames kept per sample.
+     */
+    static constexpr int max_frames = 32;
+
+    /**
+     * @brief Interval at which the collecting thread drains the rings.
+     */
+    static constexpr std::chrono::milliseconds collect_interval{100};
+
+    SignalProfiler();
+    ~SignalProfiler();
+
+    // The signal handler and the tick timer refer to this object
+    SignalProfiler(const SignalProfiler &) = delete;
+    SignalProfiler &operator=(const SignalProfiler &) = delete;
+
+    /**
+     * @brief Starts a profiling window.
+     *
+     * @param window How long to sample.
+     * @param hz Samples per second of CPU time.
+     * @param tick_signo Signal the collection timer delivers; must be in
+     *                   the collecting thread's wait set.
+     * @param tid Kernel thread ID of the collecting thread.
+     * @return false if a window is already running, in this or another
+     *         profiler, or a timer could not be set.
+     */
+    bool begin(std::chrono::milliseconds window, int hz, int tick_signo, pid_t tid);
+
+    /**
+     * @brief Reports whether a window is running.
+     *
+     * @return true between `begin()` and `finish()`.
+     */
+    bool active() const noexcept;
+
+    /**
+     * @brief Reports whether a received signal is this profiler's collection tick.
+     *
+     * @param info The signal.
+     * @return true for a tick.
+     */
+    bool isTick(const siginfo_t &info) const noexcept
+    {
+        return info.si_code == SI_TIMER && info.si_value.sival_ptr == this;
+    }
+
+    /**
+     * @brief Drains the rings; returns true once the window has ended.
+     *
+     * @details Call on the collecting thread for every tick.
+     *
+     * @return true if `finish()` should now be called.
+     */
+    bool onTick();
+
+    /**
+     * @brief Stops sampling and writes the folded stacks.
+     *
+     * @param fd Descriptor to write to; not closed.
+     * @return The number of distinct stacks written, or -1 if no window ran.
+     */
+    long finish(int fd);
+
+    /**
+     * @brief Returns the samples aggregated in the current or last window.
+     *
+     * @return The sample count.
+     */
+    std::uint64_t samples() const noexcept;
+
+    /**
+     * @brief Returns the samples lost to full rings or unclaimed threads.
+     *
+     * @return The drop count.
+     */
+    std::uint64_t dropped() const noexcept;
+
+    /**
+     * @brief Abandons a window in a child after `fork()`.
+     *
+     * @details Neither timer is inherited by the child, so the window just
+     * ends there, unwritten.
+     */
+    void afterFork();
+
+private:
+    /**
+     * @brief One captured stack, leaf first.
+     */
+    struct Sample
+    {
+        int depth;               ///< Number of valid frames.
+        void *frames[max_frames]; ///< Return addresses.
+    };
+
+    /**
+     * @brief One thread's samples; the thread produces, the collector consumes.
+     */
+    struct alignas(64) Ring
+    {
+        std::atomic<pid_t> owner{0};          ///< Sampled thread, 0 if free.
+        alignas(64) std::atomic<std::size_t> head{0}; ///< Next sample to collect.
+        alignas(64) std::atomic<std::size_t> tail{0}; ///< Next slot to fill.
+        Sample samples[ring_capacity];        ///< Preallocated samples.
+    };
+
+    /**
+     * @brief SIGPROF handler; records the interrupted stack.
+     *
+     * @param sig SIGPROF.
+     * @param info Unused.
+     * @param context Unused.
+     */
+    static void onProfSignal(int sig, siginfo_t *info, void *context);
+
+    /**
+     * @brief Moves every buffered sample into `stacks`.
+     *
+     * @note Called with `mutex` held.
+     */
+    void drain();
+
+    /**
+     * @brief Stops both timers and waits for running handlers.
+     *
+     * @note Called with `mutex` held.
+     */
+    void stopTimers();
+
+    /**
+     * @brief Per-thread rings, allocated on the first `begin()`.
+     */
+    std::unique_ptr<std::array<Ring, max_threads>> rings;
+
+    /**
+     * @brief Sample counts keyed by stack, leaf first.
+     */
+    std::map<std::vector<void *>, std::uint64_t> stacks;
+
+    /**
+     * @brief Serializes windows and collection.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief The collection timer.
+     */
+    timer_t timer;
+
+    /**
+     * @brief Whether `timer` exists.
+     */
+    bool timer_armed;
+
+    /**
+     * @brief Set while a window is running.
+     */
+    std::atomic<bool> running;
+
+    /**
+     * @brief When the window ends, CLOCK_MONOTONIC nanoseconds.
+     */
+    std::int64_t deadline_ns;
+
+    /**
+     * @brief Samples aggregated in this window.
+     */
+    std::atomic<std::uint64_t> sample_count;
+
+    /**
+     * @brief Samples dropped in this window.
+     */
+    std::atomic<std::uint64_t> drop_count;
+};
+
+#endif // SIGNAL_PROFILER_HPP
@@ -0,0 +1,222 @@
+/**
+ * @file signal_rcu.hpp
+ * @brief Minimal read-copy-update domain for lock-free handler dispatch.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_RCU_HPP
+#define SIGNAL_RCU_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief A small RCU domain: lock-free readers, blocking writers.
+ *
+ * @details
+ * Each reader thread claims a slot holding a sequence counter that is odd
+ * while the thread is inside a read-side section. Writers publish a new
+ * pointer and then call `synchronize()`, which waits until every reader
+ * that was inside a section at that moment has left it. After that the old
+ * object can be reused or destroyed.
+ *
+ * Read-side cost is one relaxed store, one fence and one release store.
+ * Writers are expected to be rare (handler registration) and may spin.
+ */
+class SignalRcu
+{
+public:
+    /**
+     * @brief Maximum number of concurrently registered reader threads.
+     */
+    static constexpr std::size_t max_readers = 64;
+
+    SignalRcu() = default;
+
+    // Readers refer to their slot by index into this object
+    SignalRcu(const SignalRcu &) = delete;
+    SignalRcu &operator=(const SignalRcu &) = delete;
+
+    /**
+     * @brief Claims a reader slot.
+     *
+     * @return The slot index, or -1 if all slots are taken.
+     */
+    int registerReader() noexcept
+    {
+        for (std::size_t i = 0; i < max_readers; ++i)
+        {
+            bool expected = false;
+            if (readers[i].used.compare_exchange_strong(expected, true,
+                                                        std::memory_order_acq_rel))
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Releases a reader slot claimed with `registerReader()`.
+     *
+     * @details Also closes a read-side section left open by a thread that
+     * no longer exists, such as one lost to `fork()`, so the slot can be
+     * reused.
+     *
+     * @param id The slot index; ignored if negative.
+     */
+    void unregisterReader(int id) noexcept
+    {
+        if (id >= 0)
+        {
+            Reader &r = readers[id];
+            std::uint64_t seq = r.seq.load(std::memory_order_relaxed);
+            if ((seq & 1) != 0)
+            {
+                r.seq.store(seq + 1, std::memory_order_release);
+            }
+            r.used.store(false, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Enters a read-side section.
+     *
+     * @param id The calling thread's reader slot.
+     */
+    void readLock(int id) noexcept
+    {
+        Reader &r = readers[id];
+        r.seq.store(r.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ++depth();
+    }
+
+    /**
+     * @brief Leaves a read-side section.
+     *
+     * @param id The calling thread's reader slot.
+     */
+    void readUnlock(int id) noexcept
+    {
+        --depth();
+        Reader &r = readers[id];
+        r.seq.store(r.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Waits until all readers present at the call have left their section.
+     *
+     * @warning Must not be called from inside a read-side section.
+     */
+    void synchronize() const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        for (const Reader &r : readers)
+        {
+            if (!r.used.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            std::uint64_t seq = r.seq.load(std::memory_order_acquire);
+            if ((seq & 1) == 0)
+            {
+                continue; // Quiescent
+            }
+
+            while (r.seq.load(std::memory_order_acquire) == seq)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Reports whether the calling thread is inside any read-side section.
+     *
+     * @return true if `synchronize()` would deadlock on this thread.
+     */
+    static bool inReadSection() noexcept
+    {
+        return depth() > 0;
+    }
+
+    /**
+     * @brief Scoped read-side section.
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard(SignalRcu &domain, int id) noexcept : rcu(domain), reader(id)
+        {
+            rcu.readLock(reader);
+        }
+
+        ~ReadGuard()
+        {
+            rcu.readUnlock(reader);
+        }
+
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+    private:
+        SignalRcu &rcu;
+        int reader;
+    };
+
+private:
+    /**
+     * @brief One reader's state, padded to avoid false sharing.
+     */
+    struct alignas(64) Reader
+    {
+        std::atomic<bool> used{false};
+        std::atomic<std::uint64_t> seq{0};
+    };
+
+    /**
+     * @brief Per-thread nesting depth of read-side sections.
+     *
+     * @return Reference to the calling thread's counter.
+     */
+    static int &depth() noexcept
+    {
+        static thread_local int value = 0;
+        return value;
+    }
+
+    /**
+     * @brief Reader slots.
+     */
+    Reader readers[max_readers];
+};
+
+#endif // SIGNAL_RCU_HPP
@@ -0,0 +1,474 @@
+/**
+ * @file signal_registry.cpp
+ * @brief Process-wide, reference-counted registry of SignalHandler instances.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_registry.hpp"
+#include "signal_handler.hpp"
+
+// Standard libraries
+#include <thread>
+
+// System libraries
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief Returns the process-wide registry.
+ *
+ * @details Allocated once and deliberately leaked: a global SignalHandler
+ * is destroyed after function-local statics, and must still be able to
+ * unsubscribe then.
+ *
+ * @return The registry.
+ */
+SignalRegistry &SignalRegistry::instance()
+{
+    static SignalRegistry *registry = new SignalRegistry();
+    return *registry;
+}
+
+/**
+ * @brief Constructs an empty registry.
+ */
+SignalRegistry::SignalRegistry()
+    : blocked_here(0),
+      in_flight(0),
+      subscriber_count(0),
+      terminal_slots(0),
+      termios_saved(false),
+      terminal_inherited(false),
+      mask_saved(false)
+{
+    for (auto &handler : handlers)
+    {
+        handler.store(nullptr, std::memory_order_relaxed);
+    }
+    masks.fill(0);
+    refs.fill(0);
+    for (auto &bits : subscriber_bits)
+    {
+        bits.store(0, std::memory_order_relaxed);
+    }
+    sigemptyset(&original_mask);
+
+    pthread_atfork(&SignalRegistry::prepareFork, &SignalRegistry::parentFork,
+                   &SignalRegistry::childFork);
+}
+
+/**
+ * @brief Subscribes an instance to a set of signals.
+ *
+ * @param handler The subscriber.
+ * @param mask Its signals.
+ * @param preblocked Signals the subscriber blocked before subscribing.
+ * @return The slot, or -1 if the registry is full.
+ */
+int SignalRegistry::subscribe(SignalHandler *handler, std::uint64_t mask, std::uint64_t preblocked)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int slot = -1;
+    for (std::size_t i = 0; i < max_subscribers; ++i)
+    {
+        if (handlers[i].load(std::memory_order_relaxed) == nullptr)
+        {
+            slot = static_cast<int>(i);
+            break;
+        }
+    }
+    if (slot < 0)
+    {
+        return -1;
+    }
+
+    if (!mask_saved)
+    {
+        pthread_sigmask(SIG_BLOCK, nullptr, &original_mask);
+        mask_saved = true;
+    }
+
+    ++subscriber_count;
+
+    // Visible to fanOut() before any of its bits are
+    handlers[slot].store(handler, std::memory_order_release);
+    acquire(slot, mask, preblocked);
+    return slot;
+}
+
+/**
+ * @brief Takes a terminal reference for a subscriber.
+ *
+ * @details The first reference saves the terminal settings and disables
+ * ECHOCTL, so `^C` is not echoed. A forked child keeps the settings its
+ * parent saved. Taking a reference twice from one slot has no effect.
+ *
+ * @param slot The subscriber slot.
+ * @return `true` if the terminal settings are saved.
+ */
+bool SignalRegistry::acquireTerminal(int slot)
+{
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handlers[slot].load(std::memory_order_relaxed) == nullptr)
+    {
+        return false;
+    }
+
+    std::uint64_t bit = std::uint64_t{1} << slot;
+    if ((terminal_slots & bit) != 0)
+    {
+        return termios_saved;
+    }
+
+    if (!termios_saved && tcgetattr(STDIN_FILENO, &original_termios) == 0)
+    {
+        termios_saved = true;
+
+        // Make a copy and update it to disable ECHOCTL if available
+        termios new_termios = original_termios;
+#ifdef ECHOCTL
+        new_termios.c_lflag &= ~ECHOCTL; // Don't echo control characters
+#endif
+        tcsetattr(STDIN_FILENO, TCSANOW, &new_termios); // Apply changes immediately
+    }
+
+    // Only a reference that found a terminal restores it
+    if (termios_saved)
+    {
+        terminal_slots |= bit;
+    }
+    return termios_saved;
+}
+
+/**
+ * @brief Adds signals to a subscription.
+ *
+ * @param slot The subscriber slot.
+ * @param mask The subscriber's new mask.
+ */
+void SignalRegistry::extend(int slot, std::uint64_t mask)
+{
+    if (slot < 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    acquire(slot, mask & ~masks[slot]);
+}
+
+/**
+ * @brief Takes a reference on each new signal.
+ *
+ * @details
+ * A signal's first reference blocks it in the calling thread. If it was
+ * not blocked there already, it is remembered in `blocked_here` so the
+ * last release can unblock it again.
+ *
+ * @param slot The subscriber slot.
+ * @param bits Signals not yet held by `slot`.
+ * @param preblocked Signals to treat as unblocked beforehand.
+ */
+void SignalRegistry::acquire(int slot, std::uint64_t bits, std::uint64_t preblocked)
+{
+    if (bits == 0)
+    {
+        return;
+    }
+
+    sigset_t current;
+    pthread_sigmask(SIG_BLOCK, nullptr, &current);
+
+    sigset_t block;
+    sigemptyset(&block);
+    for (int sig = 1; sig < signal_limit; ++sig)
+    {
+        std::uint64_t bit = SignalHandler::signalBit(sig);
+        if ((bits & bit) == 0)
+        {
+            continue;
+        }
+
+        if (refs[sig]++ == 0 && ((preblocked & bit) != 0 || sigismember(&current, sig) != 1))
+        {
+            sigaddset(&block, sig);
+            blocked_here |= bit;
+        }
+        subscriber_bits[sig].fetch_or(std::uint64_t{1} << slot);
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &block, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("pthread_sigmask");
+#endif
+    }
+
+    masks[slot] |= bits;
+}
+
+/**
+ * @brief Ends a subscription.
+ *
+ * @details
+ * Clears the slot's bits first, then waits for fan-outs already past that
+ * point, a grace period of at most one `fanOut()` call. Signals and the
+ * terminal are restored only when their last reference goes.
+ *
+ * @param slot The subscriber slot.
+ */
+void SignalRegistry::unsubscribe(int slot)
+{
+    if (slot < 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handlers[slot].load(std::memory_order_relaxed) == nullptr)
+    {
+        return;
+    }
+
+    sigset_t unblock;
+    sigemptyset(&unblock);
+    for (int sig = 1; sig < signal_limit; ++sig)
+    {
+        std::uint64_t bit = SignalHandler::signalBit(sig);
+        if ((masks[slot] & bit) == 0)
+        {
+            continue;
+        }
+
+        subscriber_bits[sig].fetch_and(~(std::uint64_t{1} << slot));
+        if (--refs[sig] == 0 && (blocked_here & bit) != 0)
+        {
+            sigaddset(&unblock, sig);
+            blocked_here &= ~bit;
+        }
+    }
+
+    while (in_flight.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    handlers[slot].store(nullptr, std::memory_order_relaxed);
+    masks[slot] = 0;
+
+    --subscriber_count;
+
+    std::uint64_t bit = std::uint64_t{1} << slot;
+    if ((terminal_slots & bit) != 0)
+    {
+        terminal_slots &= ~bit;
+        if (terminal_slots == 0 && termios_saved && !terminal_inherited)
+        {
+            tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
+            termios_saved = false;
+        }
+    }
+
+    // The last subscriber has drained these, nothing else waits on them now
+    pthread_sigmask(SIG_UNBLOCK, &unblock, nullptr);
+}
+
+/**
+ * @brief Hands a received signal to every other subscriber of it.
+ *
+ * @details Lock-free. With no other subscriber this is a single relaxed
+ * load; otherwise one counter increment, one load of the signal's
+ * subscriber bitmap and one `forward()` per other subscriber.
+ *
+ * @param from The receiving slot.
+ * @param info The signal.
+ * @return The number of subscribers forwarded to.
+ */
+std::size_t SignalRegistry::fanOut(int from, const siginfo_t &info)
+{
+    int sig = info.si_signo;
+    if (from < 0 || sig <= 0 || sig >= signal_limit)
+    {
+        return 0;
+    }
+
+    // The common single-instance case touches nothing shared but this load
+    std::uint64_t self = std::uint64_t{1} << from;
+    if ((subscriber_bits[sig].load(std::memory_order_relaxed) & ~self) == 0)
+    {
+        return 0;
+    }
+
+    in_flight.fetch_add(1);
+    std::uint64_t others = subscriber_bits[sig].load() & ~self;
+
+    std::size_t forwarded = 0;
+    while (others != 0)
+    {
+        int slot = __builtin_ctzll(others);
+        others &= others - 1;
+        handlers[slot].load(std::memory_order_acquire)->forward(info);
+        ++forwarded;
+    }
+
+    in_flight.fetch_sub(1);
+    return forwarded;
+}
+
+/**
+ * @brief Returns the number of subscribers of a signal.
+ *
+ * @param signum The signal number.
+ * @return The reference count, 0 if out of range.
+ */
+std::size_t SignalRegistry::subscribers(int signum) const
+{
+    if (signum <= 0 || signum >= signal_limit)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return refs[signum];
+}
+
+/**
+ * @brief Returns the number of subscribed instances.
+ *
+ * @return The count.
+ */
+std::size_t SignalRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriber_count;
+}
+
+/**
+ * @brief Records the calling thread's signal mask, the first time only.
+ */
+void SignalRegistry::saveOriginalMask()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mask_saved)
+    {
+        pthread_sigmask(SIG_BLOCK, nullptr, &original_mask);
+        mask_saved = true;
+    }
+}
+
+/**
+ * @brief Restores the original signal mask and terminal settings.
+ *
+ * @details
+ * Without a saved mask, every signal this registry blocked is unblocked
+ * instead. In a forked child the terminal is the parent's too, so
+ * restoring it turns ECHOCTL back on for both until the parent's handler
+ * stops.
+ *
+ * @param restore_terminal Also restore the terminal settings.
+ */
+void SignalRegistry::restoreForExec(bool restore_terminal) const noexcept
+{
+    if (mask_saved)
+    {
+        pthread_sigmask(SIG_SETMASK, &original_mask, nullptr);
+    }
+    else
+    {
+        sigset_t unblock;
+        sigemptyset(&unblock);
+        for (int sig = 1; sig < signal_limit; ++sig)
+        {
+            if ((blocked_here & SignalHandler::signalBit(sig)) != 0)
+            {
+                sigaddset(&unblock, sig);
+            }
+        }
+        pthread_sigmask(SIG_UNBLOCK, &unblock, nullptr);
+    }
+
+    if (restore_terminal && termios_saved)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
+    }
+}
+
+/**
+ * @brief Holds the subscription lock across `fork()`.
+ *
+ * @details The child then never inherits a half-made subscription change.
+ */
+void SignalRegistry::prepareFork()
+{
+    instance().mutex.lock();
+}
+
+/**
+ * @brief Releases the subscription lock in the parent.
+ */
+void SignalRegistry::parentFork()
+{
+    instance().mutex.unlock();
+}
+
+/**
+ * @brief Recovers every subscriber in the child.
+ *
+ * @details
+ * Only the forking thread exists in the child, so no fan-out can be in
+ * flight and the lock taken by `prepareFork()` is ours to release. Each
+ * subscriber is then recovered with the lock released, since detaching
+ * one unsubscribes it.
+ */
+void SignalRegistry::childFork()
+{
+    SignalRegistry &registry = instance();
+    registry.in_flight.store(0);
+    registry.terminal_inherited = true;
+
+    std::array<SignalHandler *, max_subscribers> subscribed;
+    std::size_t count = 0;
+    for (auto &handler : registry.handlers)
+    {
+        SignalHandler *h = handler.load(std::memory_order_relaxed);
+        if (h != nullptr)
+        {
+            subscribed[count++] = h;
+        }
+    }
+    registry.mutex.unlock();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        subscribed[i]->afterFork();
+    }
+}
@@ -0,0 +1,284 @@
+/**
+ * @file signal_registry.hpp
+ * @brief Process-wide, reference-counted registry of SignalHandler instances.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_REGISTRY_HPP
+#define SIGNAL_REGISTRY_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// System libraries
+#include <termios.h>
+
+class SignalHandler;
+
+/**
+ * @brief Shares signal masks, terminal settings and deliveries between instances.
+ *
+ * @details
+ * Every running SignalHandler subscribes here with the signals it waits on.
+ * Process state is reference counted:
+ * - A signal is blocked in the calling thread when its first subscriber
+ *   arrives, and unblocked when its last one leaves, unless it was already
+ *   blocked beforehand.
+ * - Terminal settings are saved and ECHOCTL disabled by the first
+ *   subscriber to call `acquireTerminal()`, and restored when the last of
+ *   those leaves.
+ *
+ * A process-directed signal is consumed by whichever subscriber's thread
+ * happens to wait for it first. That instance calls `fanOut()`, which hands
+ * a copy to every other subscriber of the signal. Subscribers per signal
+ * are kept as a bitmap, so a fan-out visits only the instances concerned.
+ *
+ * Masks are per thread; start and stop handlers from the same thread (or
+ * with the signals already blocked, as with `block_signals()`) for the
+ * restore to match.
+ *
+ * The registry also owns the process's `pthread_atfork()` handlers. A fork
+ * waits for any subscription change in progress, and the child hands each
+ * subscribed instance to `SignalHandler::afterFork()`, which rebuilds or
+ * releases it according to its `ForkMode`.
+ */
+class SignalRegistry
+{
+public:
+    /**
+     * @brief Maximum number of concurrently subscribed instances.
+     */
+    static constexpr std::size_t max_subscribers = 64;
+
+    /**
+     * @brief Returns the process-wide registry.
+     *
+     * @details Never destroyed, so handlers with static storage duration
+     * can still unsubscribe during exit.
+     *
+     * @return The registry.
+     */
+    static SignalRegistry &instance();
+
+    // One per process
+    SignalRegistry(const SignalRegistry &) = delete;
+    SignalRegistry &operator=(const SignalRegistry &) = delete;
+
+    /**
+     * @brief Subscribes an instance to a set of signals.
+     *
+     * @param handler The subscriber.
+     * @param mask Its signals, in `SignalHandler::signalBit()` layout.
+     * @param preblocked Signals in `mask` the subscriber blocked itself
+     *                   before subscribing, to be unblocked like the rest.
+     * @return The subscriber slot, or -1 if every slot is taken.
+     */
+    int subscribe(SignalHandler *handler, std::uint64_t mask, std::uint64_t preblocked = 0);
+
+    /**
+     * @brief Saves the terminal and disables ECHOCTL on behalf of a subscriber.
+     *
+     * @details Separate from `subscribe()` so a subscriber can skip the
+     * terminal, or take it later from another thread.
+     *
+     * @param slot The slot from `subscribe()`.
+     * @return true if the terminal settings are saved, false if stdin is
+     *         not a terminal or the slot is not subscribed.
+     */
+    bool acquireTerminal(int slot);
+
+    /**
+     * @brief Adds signals to a subscription.
+     *
+     * @param slot The slot from `subscribe()`.
+     * @param mask The subscriber's full new mask; bits are only ever added.
+     */
+    void extend(int slot, std::uint64_t mask);
+
+    /**
+     * @brief Ends a subscription, releasing its signals and terminal reference.
+     *
+     * @details Waits for any fan-out in flight to finish, so the handler can
+     * be destroyed as soon as this returns.
+     *
+     * @param slot The slot from `subscribe()`; ignored if negative.
+     */
+    void unsubscribe(int slot);
+
+    /**
+     * @brief Hands a received signal to every other subscriber of it.
+     *
+     * @param from The receiving subscriber's slot.
+     * @param info The signal.
+     * @return The number of subscribers it was forwarded to.
+     */
+    std::size_t fanOut(int from, const siginfo_t &info);
+
+    /**
+     * @brief Returns the number of subscribers of a signal.
+     *
+     * @param signum The signal number.
+     * @return The reference count.
+     */
+    std::size_t subscribers(int signum) const;
+
+    /**
+     * @brief Returns the number of subscribed instances.
+     *
+     * @return The count.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Records the calling thread's signal mask, the first time only.
+     *
+     * @details Called before anything here or in `block_signals()` blocks a
+     * signal, so `restoreForExec()` knows the mask to go back to.
+     */
+    void saveOriginalMask();
+
+    /**
+     * @brief Restores the original signal mask and terminal settings.
+     *
+     * @details Takes no lock and calls only async-signal-safe functions, so
+     * it may run in a child between `fork()` and `exec()`.
+     *
+     * @param restore_terminal Also restore the saved terminal settings.
+     */
+    void restoreForExec(bool restore_terminal) const noexcept;
+
+private:
+    SignalRegistry();
+
+    /**
+     * @brief `pthread_atfork()` prepare handler; holds `mutex` across the fork.
+     */
+    static void prepareFork();
+
+    /**
+     * @brief `pthread_atfork()` parent handler; releases `mutex`.
+     */
+    static void parentFork();
+
+    /**
+     * @brief `pthread_atfork()` child handler; recovers every subscriber.
+     */
+    static void childFork();
+
+    /**
+     * @brief Takes a reference on each signal in `bits`.
+     *
+     * @note Called with `mutex` held.
+     *
+     * @param slot The subscriber taking the references.
+     * @param bits The signals, none of them already held by `slot`.
+     * @param preblocked Signals to treat as unblocked beforehand.
+     */
+    void acquire(int slot, std::uint64_t bits, std::uint64_t preblocked = 0);
+
+    /**
+     * @brief One past the highest signal number.
+     */
+    static constexpr int signal_limit = _NSIG;
+
+    /**
+     * @brief Serializes subscription changes.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Subscribed instances, nullptr for a free slot.
+     */
+    std::array<std::atomic<SignalHandler *>, max_subscribers> handlers;
+
+    /**
+     * @brief Signals held by each slot.
+     */
+    std::array<std::uint64_t, max_subscribers> masks;
+
+    /**
+     * @brief Subscriber slots per signal, one bit per slot; read by `fanOut()`.
+     */
+    std::array<std::atomic<std::uint64_t>, signal_limit> subscriber_bits;
+
+    /**
+     * @brief Subscriber count per signal.
+     */
+    std::array<std::uint32_t, signal_limit> refs;
+
+    /**
+     * @brief Signals this registry blocked and must unblock on last release.
+     */
+    std::uint64_t blocked_here;
+
+    /**
+     * @brief Number of fan-outs currently reading `handlers`.
+     */
+    std::atomic<std::uint32_t> in_flight;
+
+    /**
+     * @brief Number of subscribed instances.
+     */
+    std::size_t subscriber_count;
+
+    /**
+     * @brief Slots holding a terminal reference, one bit per slot.
+     */
+    std::uint64_t terminal_slots;
+
+    /**
+     * @brief Terminal settings saved by the first `acquireTerminal()`.
+     */
+    termios original_termios;
+
+    /**
+     * @brief Whether `original_termios` holds valid settings.
+     */
+    bool termios_saved;
+
+    /**
+     * @brief Set in a forked child, whose terminal is shared with its parent.
+     * @details The last subscriber then leaves the terminal alone, and only
+     * `restoreForExec()` puts the saved settings back.
+     */
+    bool terminal_inherited;
+
+    /**
+     * @brief Signal mask recorded by `saveOriginalMask()`.
+     */
+    sigset_t original_mask;
+
+    /**
+     * @brief Whether `original_mask` is valid.
+     */
+    bool mask_saved;
+};
+
+#endif // SIGNAL_REGISTRY_HPP
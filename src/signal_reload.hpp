@@ -0,0 +1,306 @@
+/**
+ * @file signal_reload.hpp
+ * @brief Hot-reloadable configuration with wait-free readers.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_RELOAD_HPP
+#define SIGNAL_RELOAD_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief An immutable configuration object that can be replaced at runtime.
+ *
+ * @details
+ * `reload()` runs the user loader, publishes the new object with one atomic
+ * pointer exchange and retires the old one. Readers call `get()`, a single
+ * acquire load, and never block or write shared state while reading.
+ *
+ * Reclamation is quiescent-state based (QSBR), a form of epoch-based
+ * reclamation. Each reader thread registers once and calls `quiescent()`
+ * at points where it holds no pointer from `get()`, typically once per
+ * request loop iteration. A retired object is freed once every registered
+ * reader has passed a quiescent point after the object was replaced.
+ * Reclamation runs on the reloading thread and never waits. A reader that
+ * stalls only delays freeing, and `retired()` shows how much is pending.
+ *
+ * @tparam T The configuration type.
+ */
+template <typename T>
+class SignalReloadable
+{
+public:
+    /**
+     * @brief Builds a new configuration; returns nullptr to keep the current one.
+     */
+    using Loader = std::function<std::unique_ptr<T>()>;
+
+    /**
+     * @brief Maximum number of concurrently registered reader threads.
+     */
+    static constexpr std::size_t max_readers = 64;
+
+    /**
+     * @brief Creates the holder and performs the initial load.
+     *
+     * @param load The loader; called now and on every `reload()`.
+     */
+    explicit SignalReloadable(Loader load) : loader(std::move(load))
+    {
+        reload();
+    }
+
+    ~SignalReloadable()
+    {
+        delete current.load(std::memory_order_relaxed);
+        for (auto &entry : retired_list)
+        {
+            delete entry.second;
+        }
+    }
+
+    // Readers hold raw pointers into this object
+    SignalReloadable(const SignalReloadable &) = delete;
+    SignalReloadable &operator=(const SignalReloadable &) = delete;
+
+    /**
+     * @brief Returns the current configuration.
+     *
+     * @details Valid until the calling reader's next `quiescent()` call.
+     *
+     * @return The configuration, or nullptr if no load has succeeded.
+     */
+    const T *get() const noexcept
+    {
+        return current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Runs the loader and publishes its result.
+     *
+     * @details Bound to SIGHUP with `SignalHandler::bindReload()` this runs
+     * on the signal thread, off every reader's hot path. A loader that
+     * returns nullptr or throws leaves the current configuration in place.
+     *
+     * @return true if a new configuration was published.
+     */
+    bool reload()
+    {
+        std::unique_ptr<T> fresh;
+        try
+        {
+            fresh = loader ? loader() : nullptr;
+        }
+        catch (...)
+        {
+            fresh.reset();
+        }
+
+        if (!fresh)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const T *old = current.exchange(fresh.release(), std::memory_order_acq_rel);
+
+        // Readers announcing this epoch or later can no longer see `old`
+        std::uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (old != nullptr)
+        {
+            retired_list.emplace_back(epoch, old);
+        }
+
+        reclaim();
+        return true;
+    }
+
+    /**
+     * @brief Claims a reader slot for the calling thread.
+     *
+     * @return The slot index, or -1 if all slots are taken.
+     */
+    int registerReader() noexcept
+    {
+        for (std::size_t i = 0; i < max_readers; ++i)
+        {
+            std::uint64_t expected = offline;
+            if (readers[i].epoch.compare_exchange_strong(expected,
+                                                         global_epoch.load(std::memory_order_acquire),
+                                                         std::memory_order_acq_rel))
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Releases a reader slot; the thread must hold no pointers.
+     *
+     * @param id The slot index; ignored if negative.
+     */
+    void unregisterReader(int id) noexcept
+    {
+        if (id >= 0)
+        {
+            readers[id].epoch.store(offline, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Declares that the calling reader holds no configuration pointer.
+     *
+     * @details One acquire load and one release store to the reader's own
+     * cache line.
+     *
+     * @param id The calling thread's reader slot.
+     */
+    void quiescent(int id) noexcept
+    {
+        readers[id].epoch.store(global_epoch.load(std::memory_order_acquire),
+                                std::memory_order_release);
+    }
+
+    /**
+     * @brief Frees every retired configuration no reader can still hold.
+     *
+     * @details Called by `reload()`; call it directly to reclaim sooner.
+     */
+    void collect()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reclaim();
+    }
+
+    /**
+     * @brief Returns the number of configurations published so far.
+     *
+     * @return The publish count, including the initial load.
+     */
+    std::uint64_t version() const noexcept
+    {
+        return global_epoch.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns how many replaced configurations await reclamation.
+     *
+     * @return The number of retired objects not yet freed.
+     */
+    std::size_t retired() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return retired_list.size();
+    }
+
+private:
+    /**
+     * @brief Reader epoch value for an unused slot.
+     */
+    static constexpr std::uint64_t offline = ~std::uint64_t{0};
+
+    /**
+     * @brief One reader's last announced epoch, padded to avoid false sharing.
+     */
+    struct alignas(64) Reader
+    {
+        std::atomic<std::uint64_t> epoch{offline};
+    };
+
+    /**
+     * @brief Frees retired objects older than every reader's epoch.
+     *
+     * @note Called with `mutex` held.
+     */
+    void reclaim()
+    {
+        std::uint64_t oldest = offline;
+        for (const Reader &r : readers)
+        {
+            std::uint64_t e = r.epoch.load(std::memory_order_acquire);
+            if (e < oldest)
+            {
+                oldest = e;
+            }
+        }
+
+        std::size_t kept = 0;
+        for (auto &entry : retired_list)
+        {
+            if (entry.first <= oldest)
+            {
+                delete entry.second;
+            }
+            else
+            {
+                retired_list[kept++] = entry;
+            }
+        }
+        retired_list.resize(kept);
+    }
+
+    /**
+     * @brief Builds new configurations.
+     */
+    Loader loader;
+
+    /**
+     * @brief The published configuration.
+     */
+    alignas(64) std::atomic<const T *> current{nullptr};
+
+    /**
+     * @brief Incremented after every publish.
+     */
+    alignas(64) std::atomic<std::uint64_t> global_epoch{0};
+
+    /**
+     * @brief Reader slots.
+     */
+    Reader readers[max_readers];
+
+    /**
+     * @brief Serializes reloads and reclamation.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Replaced objects and the epoch at which they were replaced.
+     */
+    std::vector<std::pair<std::uint64_t, const T *>> retired_list;
+};
+
+#endif // SIGNAL_RELOAD_HPP
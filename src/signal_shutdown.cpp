@@ -0,0 +1,437 @@
+/**
+ * @file signal_shutdown.cpp
+ * @brief Phased, parallel shutdown with per-phase deadlines and escalation.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_shutdown.hpp"
+
+// Standard libraries
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <iostream> // Debug printing
+#endif
+
+/**
+ * @brief Phase state values for `state`.
+ */
+static constexpr int state_idle = 0;
+static constexpr int state_running = 1;
+static constexpr int state_finished = 2;
+
+/**
+ * @brief Constructs a coordinator with no hooks and no deadlines.
+ *
+ * @details The default escalation action is `std::_Exit(EXIT_FAILURE)`,
+ * which skips static destructors and `atexit()` handlers that may be the
+ * very thing hanging.
+ */
+SignalShutdown::SignalShutdown()
+    : pool_size(4),
+      escalation([](Phase)
+                 { std::_Exit(EXIT_FAILURE); }),
+      state(state_idle),
+      current_phase(0),
+      escalated(false),
+      succeeded(false),
+      phase_remaining(0)
+{
+    deadlines.fill(std::chrono::milliseconds::zero());
+}
+
+/**
+ * @brief Destructor; waits for a shutdown started with `begin()`.
+ */
+SignalShutdown::~SignalShutdown()
+{
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        thread = std::move(runner);
+    }
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Adds a hook to a phase.
+ *
+ * @param phase The phase to run the hook in.
+ * @param name Name reported if the hook misses its deadline.
+ * @param hook The hook.
+ * @return `true` if the hook was added.
+ */
+bool SignalShutdown::addHook(Phase phase, std::string name, Hook hook)
+{
+    if (!hook || static_cast<std::size_t>(phase) >= phase_count)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state.load() != state_idle)
+    {
+        return false;
+    }
+
+    hooks[static_cast<std::size_t>(phase)].emplace_back(new HookEntry(std::move(name), std::move(hook)));
+    return true;
+}
+
+/**
+ * @brief Sets a phase's deadline.
+ *
+ * @param phase The phase.
+ * @param deadline Maximum duration; zero means no limit.
+ */
+void SignalShutdown::setDeadline(Phase phase, std::chrono::milliseconds deadline)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    deadlines[static_cast<std::size_t>(phase)] = deadline;
+}
+
+/**
+ * @brief Sets the number of hooks run concurrently.
+ *
+ * @param threads Pool size, clamped to at least 1.
+ */
+void SignalShutdown::setParallelism(std::size_t threads)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pool_size = std::max<std::size_t>(threads, 1);
+}
+
+/**
+ * @brief Returns the pool size.
+ *
+ * @return The maximum number of concurrent hooks.
+ */
+std::size_t SignalShutdown::parallelism() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pool_size;
+}
+
+/**
+ * @brief Replaces the escalation action.
+ *
+ * @param action The new action; an empty function restores the default.
+ */
+void SignalShutdown::setEscalation(EscalationAction action)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (action)
+    {
+        escalation = std::move(action);
+    }
+    else
+    {
+        escalation = [](Phase)
+        { std::_Exit(EXIT_FAILURE); };
+    }
+}
+
+/**
+ * @brief Reports whether any hooks are registered.
+ *
+ * @return `true` if at least one phase has a hook.
+ */
+bool SignalShutdown::hasHooks() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &list : hooks)
+    {
+        if (!list.empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Starts the shutdown on a background thread.
+ *
+ * @details The thread inherits the caller's signal mask; from the signal
+ * thread that is every signal blocked, so hooks are never interrupted.
+ * `runner` is assigned under `mutex`, since the destructor may run on
+ * another thread as soon as the phases finish.
+ *
+ * @return `true` if this call started the shutdown.
+ */
+bool SignalShutdown::begin()
+{
+    int expected = state_idle;
+    if (!state.compare_exchange_strong(expected, state_running))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    runner = std::thread([this]
+                         { runPhases(); });
+    return true;
+}
+
+/**
+ * @brief Runs the shutdown on the calling thread.
+ *
+ * @return `true` if every phase finished in time.
+ */
+bool SignalShutdown::run()
+{
+    int expected = state_idle;
+    if (!state.compare_exchange_strong(expected, state_running))
+    {
+        return false;
+    }
+
+    return runPhases();
+}
+
+/**
+ * @brief Waits for the shutdown to finish.
+ *
+ * @details Sleeps on `finished` rather than joining `runner`, which the
+ * thread calling `begin()` may still be assigning. Any number of threads
+ * may wait; the destructor joins the runner.
+ *
+ * @return `true` if it completed without escalating.
+ */
+bool SignalShutdown::wait()
+{
+    if (state.load() != state_idle)
+    {
+        finished.wait();
+    }
+    return succeeded.load();
+}
+
+/**
+ * @brief Reports whether a shutdown is running.
+ *
+ * @return `true` between `begin()`/`run()` and the end of the last phase.
+ */
+bool SignalShutdown::inProgress() const
+{
+    return state.load() == state_running;
+}
+
+/**
+ * @brief Escalates the running shutdown.
+ *
+ * @details
+ * Only the first call has an effect. The escalation action runs on the
+ * calling thread; if it returns, the abort token is triggered and the
+ * coordinator is woken so it can collect the stragglers and stop.
+ */
+void SignalShutdown::escalate()
+{
+    if (state.load() != state_running || escalated.exchange(true))
+    {
+        return;
+    }
+
+    Phase phase = static_cast<Phase>(current_phase.load());
+
+#ifdef DEBUG_SIGNAL_HANDLER
+    std::cerr << "Shutdown escalated during phase: " << phaseName(phase) << std::endl;
+#endif
+
+    EscalationAction action;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        action = escalation;
+    }
+    action(phase);
+
+    // A custom action returned; tell the hooks and wake the coordinator
+    abort_source.requestStop();
+    phase_done.requestStop();
+}
+
+/**
+ * @brief Returns the hooks that missed a deadline.
+ *
+ * @return Their names, in phase order.
+ */
+std::vector<std::string> SignalShutdown::failedHooks() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+/**
+ * @brief Returns a phase's name.
+ *
+ * @param phase The phase.
+ * @return The name, or "unknown".
+ */
+std::string_view SignalShutdown::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::StopAccepting:
+        return "stop-accepting";
+    case Phase::Drain:
+        return "drain";
+    case Phase::Flush:
+        return "flush";
+    case Phase::Close:
+        return "close";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Runs every phase in order.
+ *
+ * @return `true` if every phase finished in time.
+ */
+bool SignalShutdown::runPhases()
+{
+    bool ok = true;
+    for (std::size_t p = 0; p < phase_count && ok; ++p)
+    {
+        current_phase.store(p);
+        ok = runPhase(static_cast<Phase>(p)) && !escalated.load();
+    }
+
+    succeeded.store(ok);
+    state.store(state_finished);
+    finished.requestStop();
+    return ok;
+}
+
+/**
+ * @brief Runs one phase's hooks on the pool and waits for them.
+ *
+ * @details
+ * Pool threads pull hooks from a shared index, so a slow hook never holds
+ * up the others queued behind it. The coordinator sleeps on `phase_done`
+ * until the last hook returns or the deadline passes. On a miss it records
+ * the hooks that had not returned, escalates, then joins the pool (hooks
+ * see the abort token).
+ *
+ * @param phase The phase to run.
+ * @return `true` if all hooks returned in time.
+ */
+bool SignalShutdown::runPhase(Phase phase)
+{
+    std::vector<HookEntry *> list;
+    std::chrono::milliseconds deadline;
+    std::size_t threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &entry : hooks[static_cast<std::size_t>(phase)])
+        {
+            list.push_back(entry.get());
+        }
+        deadline = deadlines[static_cast<std::size_t>(phase)];
+        threads = std::min(pool_size, list.size());
+    }
+
+    if (list.empty())
+    {
+        return true;
+    }
+
+#ifdef DEBUG_SIGNAL_HANDLER
+    std::cout << "Shutdown phase: " << phaseName(phase) << " (" << list.size()
+              << " hooks)" << std::endl;
+#endif
+
+    phase_done.reset();
+    phase_remaining.store(list.size());
+
+    // An escalation that raced the reset above has already woken nobody
+    if (escalated.load())
+    {
+        return false;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([this, &list, &next]
+                          {
+            SignalStopToken abort(abort_source);
+            std::size_t i;
+            while ((i = next.fetch_add(1)) < list.size())
+            {
+                if (!abort.stopRequested())
+                {
+                    list[i]->hook(abort);
+                    list[i]->done.store(true);
+                }
+
+                if (phase_remaining.fetch_sub(1) == 1)
+                {
+                    phase_done.requestStop();
+                }
+            } });
+    }
+
+    bool on_time = true;
+    if (deadline > std::chrono::milliseconds::zero())
+    {
+        on_time = phase_done.waitFor(deadline);
+    }
+    else
+    {
+        phase_done.wait();
+    }
+
+    bool ok = on_time && !escalated.load();
+    if (!ok)
+    {
+        // Record the stragglers before the abort token lets them return
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (HookEntry *entry : list)
+            {
+                if (!entry->done.load())
+                {
+                    failed.push_back(entry->name);
+                }
+            }
+        }
+        escalate();
+    }
+
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+
+    return ok;
+}
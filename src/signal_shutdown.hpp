@@ -0,0 +1,305 @@
+/**
+ * @file signal_shutdown.hpp
+ * @brief Phased, parallel shutdown with per-phase deadlines and escalation.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_SHUTDOWN_HPP
+#define SIGNAL_SHUTDOWN_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Project libraries
+#include "signal_stop_token.hpp"
+
+/**
+ * @brief Runs registered shutdown hooks in ordered phases.
+ *
+ * @details
+ * Phases run one after another, in `Phase` order. The hooks within a phase
+ * run concurrently on up to `parallelism()` threads, so a phase takes as
+ * long as its slowest hook rather than the sum of all of them. If a phase
+ * has a deadline and its hooks have not all returned by then, or if
+ * `escalate()` is called (SignalHandler does this on a second stop signal),
+ * the escalation action runs. By default that is `std::_Exit(EXIT_FAILURE)`.
+ *
+ * Every hook gets an abort token. It is triggered on escalation, so a
+ * cooperative hook can give up early when a custom escalation action
+ * returns instead of exiting.
+ */
+class SignalShutdown
+{
+public:
+    /**
+     * @brief Shutdown phases, run in this order.
+     */
+    enum class Phase : std::size_t
+    {
+        StopAccepting = 0, ///< Stop taking new work (close listeners, deregister).
+        Drain = 1,         ///< Finish in-flight work.
+        Flush = 2,         ///< Persist buffered state.
+        Close = 3          ///< Release remaining resources.
+    };
+
+    /**
+     * @brief Number of phases.
+     */
+    static constexpr std::size_t phase_count = 4;
+
+    /**
+     * @brief A shutdown hook; should return promptly once `abort` is triggered.
+     */
+    using Hook = std::function<void(const SignalStopToken &abort)>;
+
+    /**
+     * @brief Called on escalation with the phase that was running.
+     */
+    using EscalationAction = std::function<void(Phase phase)>;
+
+    SignalShutdown();
+    ~SignalShutdown();
+
+    // Hook threads refer to this object
+    SignalShutdown(const SignalShutdown &) = delete;
+    SignalShutdown &operator=(const SignalShutdown &) = delete;
+
+    /**
+     * @brief Adds a hook to a phase.
+     *
+     * @param phase The phase to run the hook in.
+     * @param name Name reported by `failedHooks()` if the hook misses its deadline.
+     * @param hook The hook.
+     * @return false once the shutdown has begun or if `hook` is empty.
+     */
+    bool addHook(Phase phase, std::string name, Hook hook);
+
+    /**
+     * @brief Sets the time a phase may take before escalating.
+     *
+     * @param phase The phase.
+     * @param deadline Maximum duration; zero (the default) means no limit.
+     */
+    void setDeadline(Phase phase, std::chrono::milliseconds deadline);
+
+    /**
+     * @brief Sets the maximum number of hooks run at once within a phase.
+     *
+     * @param threads Pool size; at least 1. Defaults to 4.
+     */
+    void setParallelism(std::size_t threads);
+
+    /**
+     * @brief Returns the pool size set with `setParallelism()`.
+     *
+     * @return The maximum number of concurrent hooks.
+     */
+    std::size_t parallelism() const;
+
+    /**
+     * @brief Replaces the escalation action.
+     *
+     * @param action Called on a deadline miss or `escalate()`. If it returns,
+     *               the abort token is triggered, the remaining phases are
+     *               skipped and `run()` returns false.
+     */
+    void setEscalation(EscalationAction action);
+
+    /**
+     * @brief Reports whether any hooks are registered.
+     *
+     * @return true if `begin()` would do any work.
+     */
+    bool hasHooks() const;
+
+    /**
+     * @brief Runs the shutdown on a background thread, once.
+     *
+     * @return true if this call started it, false if it had already begun.
+     */
+    bool begin();
+
+    /**
+     * @brief Runs every phase on the calling thread, once.
+     *
+     * @return true if every phase finished within its deadline.
+     */
+    bool run();
+
+    /**
+     * @brief Waits for a shutdown started with `begin()` or `run()` to finish.
+     *
+     * @details Safe from any thread, concurrently with `begin()`. Returns at
+     * once if no shutdown has begun.
+     *
+     * @return true if it completed without escalating.
+     */
+    bool wait();
+
+    /**
+     * @brief Reports whether a shutdown has begun and not finished.
+     *
+     * @return true while phases are running.
+     */
+    bool inProgress() const;
+
+    /**
+     * @brief Escalates a running shutdown to a forced exit.
+     *
+     * @details Safe from any thread, including the signal thread. Has no
+     * effect unless a shutdown is in progress.
+     */
+    void escalate();
+
+    /**
+     * @brief Names of hooks that had not returned when their phase escalated.
+     *
+     * @return The hook names; valid after `run()` or `wait()` returns.
+     */
+    std::vector<std::string> failedHooks() const;
+
+    /**
+     * @brief Returns a phase's name.
+     *
+     * @param phase The phase.
+     * @return A short name, e.g. "drain".
+     */
+    static std::string_view phaseName(Phase phase);
+
+private:
+    /**
+     * @brief A registered hook and its progress in the current run.
+     */
+    struct HookEntry
+    {
+        std::string name;                 ///< Name for `failedHooks()`.
+        Hook hook;                        ///< The hook itself.
+        std::atomic<bool> done{false};    ///< Set when the hook has returned.
+
+        HookEntry(std::string n, Hook h) : name(std::move(n)), hook(std::move(h)) {}
+    };
+
+    /**
+     * @brief Runs every phase in order; the caller has claimed `state`.
+     *
+     * @return true if every phase finished in time.
+     */
+    bool runPhases();
+
+    /**
+     * @brief Runs one phase's hooks on the pool and waits for them.
+     *
+     * @param phase The phase to run.
+     * @return true if all hooks returned in time.
+     */
+    bool runPhase(Phase phase);
+
+    /**
+     * @brief Protects the hook lists, settings, `failed` and `runner`.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Hooks per phase; fixed once the shutdown begins.
+     */
+    std::array<std::vector<std::unique_ptr<HookEntry>>, phase_count> hooks;
+
+    /**
+     * @brief Deadline per phase; zero means no limit.
+     */
+    std::array<std::chrono::milliseconds, phase_count> deadlines;
+
+    /**
+     * @brief Maximum number of hooks run concurrently.
+     */
+    std::size_t pool_size;
+
+    /**
+     * @brief Action taken on escalation.
+     */
+    EscalationAction escalation;
+
+    /**
+     * @brief 0 before the shutdown, 1 while running, 2 once finished.
+     */
+    std::atomic<int> state;
+
+    /**
+     * @brief Phase currently running, for the escalation action.
+     */
+    std::atomic<std::size_t> current_phase;
+
+    /**
+     * @brief Set once the shutdown has escalated.
+     */
+    std::atomic<bool> escalated;
+
+    /**
+     * @brief Result of the last `run()`.
+     */
+    std::atomic<bool> succeeded;
+
+    /**
+     * @brief Triggered on escalation; observed by hooks.
+     */
+    SignalStopSource abort_source;
+
+    /**
+     * @brief Triggered when the current phase's last hook returns, or on escalation.
+     */
+    SignalStopSource phase_done;
+
+    /**
+     * @brief Triggered once the last phase has ended; `wait()` sleeps on it.
+     */
+    SignalStopSource finished;
+
+    /**
+     * @brief Hooks of the current phase that have not yet returned.
+     */
+    std::atomic<std::size_t> phase_remaining;
+
+    /**
+     * @brief Hooks that missed a deadline.
+     */
+    std::vector<std::string> failed;
+
+    /**
+     * @brief Thread started by `begin()`; guarded by `mutex`.
+     */
+    std::thread runner;
+};
+
+#endif // SIGNAL_SHUTDOWN_HPP
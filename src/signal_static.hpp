@@ -0,0 +1,310 @@
+/**
+ * @file signal_static.hpp
+ * @brief Header-only SignalHandler variant specialized at compile time for a fixed signal set.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_STATIC_HPP
+#define SIGNAL_STATIC_HPP
+
+// Standard Libraries
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// System libraries
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief A signal thread for a signal set fixed at compile time.
+ *
+ * @details
+ * The static counterpart of SignalHandler, for builds that know their
+ * signals up front. The wait mask and a jump table indexed by signal
+ * number are `constexpr`. Each entry is a thunk that calls `Policy`
+ * directly, so dispatch is one bounds check and one indirect call, with
+ * no `std::function`, no registry and no translation unit to link.
+ *
+ * `Policy` is any functor callable as
+ * `policy(std::integral_constant<int, Sig>{}, const siginfo_t &)` for each
+ * `Sig` in the set. Overloads per signal, or one template call operator,
+ * are resolved at compile time:
+ *
+ * @code
+ * struct Handlers
+ * {
+ *     std::atomic<bool> *stop;
+ *     void operator()(std::integral_constant<int, SIGINT>, const siginfo_t &) { *stop = true; }
+ *     void operator()(std::integral_constant<int, SIGTERM>, const siginfo_t &) { *stop = true; }
+ * };
+ * StaticSignalHandler<Handlers, SIGINT, SIGTERM> signals(Handlers{&flag});
+ * @endcode
+ *
+ * Real-time signals are numbered at run time (see
+ * `SignalHandler::rtSignal()`), so only standard signals can be listed.
+ * Like SignalHandler, the set must be blocked in every thread, and
+ * `start()` blocks it in the calling thread. `stop()` wakes the thread with
+ * a queued signal carrying this object's address, which `run()` recognizes
+ * and drops.
+ *
+ * @tparam Policy The handler functor.
+ * @tparam Sigs The signals to handle.
+ */
+template <typename Policy, int... Sigs>
+class StaticSignalHandler
+{
+    /**
+     * @brief First signal number the kernel reserves for real-time signals.
+     */
+#ifdef __SIGRTMIN
+    static constexpr int realtime_base = __SIGRTMIN;
+#else
+    static constexpr int realtime_base = 32;
+#endif
+
+    static_assert(sizeof...(Sigs) > 0, "StaticSignalHandler needs at least one signal");
+    static_assert(((Sigs > 0 && Sigs < realtime_base) && ...),
+                  "StaticSignalHandler signals must be standard signals");
+    static_assert(((Sigs != SIGKILL && Sigs != SIGSTOP) && ...),
+                  "SIGKILL and SIGSTOP cannot be handled");
+
+public:
+    /**
+     * @brief One past the highest signal number in the set.
+     */
+    static constexpr int signal_limit = std::max({Sigs...}) + 1;
+
+    /**
+     * @brief The set in `SignalHandler::signalBit()` layout.
+     */
+    static constexpr std::uint64_t mask = ((std::uint64_t{1} << (Sigs - 1)) | ...);
+
+    /**
+     * @brief Constructs the handler; nothing is blocked until `start()`.
+     *
+     * @param p The handler functor.
+     */
+    explicit StaticSignalHandler(Policy p = Policy()) : handlers(std::move(p)), running(false) {}
+
+    ~StaticSignalHandler()
+    {
+        stop();
+    }
+
+    // The signal thread refers to this object
+    StaticSignalHandler(const StaticSignalHandler &) = delete;
+    StaticSignalHandler &operator=(const StaticSignalHandler &) = delete;
+
+    /**
+     * @brief Reports whether a signal is in the set.
+     *
+     * @param signum The signal number.
+     * @return true if handled.
+     */
+    static constexpr bool handles(int signum) noexcept
+    {
+        return signum > 0 && signum < signal_limit && table[signum] != nullptr;
+    }
+
+    /**
+     * @brief Returns the set as a `sigset_t`.
+     *
+     * @return The signal set.
+     */
+    static sigset_t signalSet() noexcept
+    {
+        sigset_t set;
+        sigemptyset(&set);
+        (sigaddset(&set, Sigs), ...);
+        return set;
+    }
+
+    /**
+     * @brief Blocks the set in the calling thread and starts the signal thread.
+     *
+     * @return false if already running.
+     */
+    bool start()
+    {
+        if (running.exchange(true))
+        {
+            return false;
+        }
+
+        sigset_t set = signalSet();
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+
+        // The signal thread itself runs with every signal blocked
+        sigset_t all;
+        sigset_t previous;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &previous);
+        worker = std::thread([this]
+                             { run(); });
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        return true;
+    }
+
+    /**
+     * @brief Stops and joins the signal thread.
+     *
+     * @return false if not running.
+     */
+    bool stop()
+    {
+        if (!running.exchange(false))
+        {
+            return false;
+        }
+
+        sigval value;
+        value.sival_ptr = this;
+        pthread_sigqueue(worker.native_handle(), first_signal, value);
+        worker.join();
+        return true;
+    }
+
+    /**
+     * @brief Dispatches one record through the jump table.
+     *
+     * @details Also usable from a caller's own `sigwaitinfo()` or signalfd loop.
+     *
+     * @param info The signal.
+     * @return false if the signal is not in the set.
+     */
+    bool dispatch(const siginfo_t &info)
+    {
+        int sig = info.si_signo;
+        if (sig <= 0 || sig >= signal_limit || table[sig] == nullptr)
+        {
+            return false;
+        }
+
+        table[sig](*this, info);
+        return true;
+    }
+
+    /**
+     * @brief Returns the handler functor.
+     *
+     * @return The policy object.
+     */
+    Policy &policy() noexcept
+    {
+        return handlers;
+    }
+
+private:
+    /**
+     * @brief Jump table entry type.
+     */
+    using Thunk = void (*)(StaticSignalHandler &, const siginfo_t &);
+
+    /**
+     * @brief Signal used by `stop()` to wake the thread; any member of the set works.
+     */
+    static constexpr int first_signal = std::min({Sigs...});
+
+    /**
+     * @brief Calls the policy overload for `Sig`.
+     *
+     * @tparam Sig The signal.
+     * @param self The handler.
+     * @param info The signal information.
+     */
+    template <int Sig>
+    static void thunk(StaticSignalHandler &self, const siginfo_t &info)
+    {
+        self.handlers(std::integral_constant<int, Sig>{}, info);
+    }
+
+    /**
+     * @brief Builds the jump table.
+     *
+     * @return One thunk per listed signal, nullptr elsewhere.
+     */
+    static constexpr std::array<Thunk, signal_limit> makeTable() noexcept
+    {
+        std::array<Thunk, signal_limit> t{};
+        ((t[Sigs] = &StaticSignalHandler::template thunk<Sigs>), ...);
+        return t;
+    }
+
+    /**
+     * @brief Dispatch table indexed by signal number.
+     */
+    static constexpr std::array<Thunk, signal_limit> table = makeTable();
+
+    /**
+     * @brief Waits for and dispatches signals until `stop()`.
+     */
+    void run()
+    {
+        const sigset_t set = signalSet();
+        const pid_t self = getpid();
+        siginfo_t info;
+
+        while (true)
+        {
+            if (sigwaitinfo(&set, &info) < 0)
+            {
+                continue; // Interrupted
+            }
+
+            // Our own wake-up from stop()
+            if (info.si_code == SI_QUEUE && info.si_pid == self &&
+                info.si_value.sival_ptr == this)
+            {
+                break;
+            }
+
+            dispatch(info);
+        }
+    }
+
+    /**
+     * @brief The handler functor.
+     */
+    Policy handlers;
+
+    /**
+     * @brief Set between `start()` and `stop()`.
+     */
+    std::atomic<bool> running;
+
+    /**
+     * @brief The signal thread.
+     */
+    std::thread worker;
+};
+
+#endif // SIGNAL_STATIC_HPP
@@ -0,0 +1,481 @@
+/**
+ * @file signal_stats.hpp
+ * @brief Lock-free latency histograms and counters for the dispatch path.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_STATS_HPP
+#define SIGNAL_STATS_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// System libraries
+#include <time.h>
+
+/**
+ * @brief A point-in-time copy of a `SignalHistogram`.
+ *
+ * @details
+ * Buckets are log-linear, in the style of HdrHistogram: values below 16 ns
+ * are exact, and every power of two above that is split into 16 linear
+ * sub-buckets, bounding the relative error at 1/16 (about 6%). Values above
+ * `2^max_exponent` ns land in the last bucket.
+ */
+struct SignalHistogramSnapshot
+{
+    /**
+     * @brief log2 of the number of sub-buckets per power of two.
+     */
+    static constexpr unsigned sub_bits = 4;
+
+    /**
+     * @brief Sub-buckets per power of two.
+     */
+    static constexpr std::size_t sub_count = std::size_t{1} << sub_bits;
+
+    /**
+     * @brief Highest power of two tracked exactly (2^39 ns is about 9 minutes).
+     */
+    static constexpr unsigned max_exponent = 39;
+
+    /**
+     * @brief Total number of buckets.
+     */
+    static constexpr std::size_t bucket_count = (max_exponent - sub_bits + 2) * sub_count;
+
+    std::uint64_t count = 0;  ///< Number of recorded values.
+    std::uint64_t sum_ns = 0; ///< Sum of recorded values.
+    std::uint64_t max_ns = 0; ///< Largest recorded value.
+    std::array<std::uint64_t, bucket_count> buckets{}; ///< Per-bucket counts.
+
+    /**
+     * @brief Maps a value to its bucket.
+     *
+     * @param value_ns The value in nanoseconds.
+     * @return The bucket index.
+     */
+    static constexpr std::size_t bucketFor(std::uint64_t value_ns) noexcept
+    {
+        if (value_ns < sub_count)
+        {
+            return static_cast<std::size_t>(value_ns);
+        }
+
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value_ns));
+        if (exponent > max_exponent)
+        {
+            return bucket_count - 1;
+        }
+
+        std::size_t sub = static_cast<std::size_t>(value_ns >> (exponent - sub_bits)) & (sub_count - 1);
+        return (exponent - sub_bits + 1) * sub_count + sub;
+    }
+
+    /**
+     * @brief Returns the largest value that maps to a bucket.
+     *
+     * @param index The bucket index.
+     * @return The bucket's inclusive upper bound in nanoseconds.
+     */
+    static constexpr std::uint64_t bucketUpper(std::size_t index) noexcept
+    {
+        if (index < sub_count)
+        {
+            return index;
+        }
+
+        unsigned exponent = static_cast<unsigned>(index / sub_count) + sub_bits - 1;
+        std::uint64_t sub = index % sub_count;
+        std::uint64_t width = std::uint64_t{1} << (exponent - sub_bits);
+        return ((sub_count + sub) << (exponent - sub_bits)) + width - 1;
+    }
+
+    /**
+     * @brief Returns the value at or below which a fraction of samples fall.
+     *
+     * @details Reports the upper bound of the bucket holding the requested
+     * rank, capped at `max_ns`, so the result never understates latency.
+     *
+     * @param fraction A quantile in [0, 1], e.g. 0.99 for p99.
+     * @return The quantile in nanoseconds, or 0 if nothing was recorded.
+     */
+    std::uint64_t percentile(double fraction) const noexcept
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        if (fraction < 0.0)
+            fraction = 0.0;
+        if (fraction > 1.0)
+            fraction = 1.0;
+
+        // Rank of the requested sample, counting from 1
+        std::uint64_t rank = static_cast<std::uint64_t>(fraction * static_cast<double>(count) + 0.5);
+        if (rank == 0)
+            rank = 1;
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+            {
+                std::uint64_t upper = bucketUpper(i);
+                return upper < max_ns ? upper : max_ns;
+            }
+        }
+        return max_ns;
+    }
+
+    /**
+     * @brief Returns the arithmetic mean of the recorded values.
+     *
+     * @return The mean in nanoseconds, or 0 if nothing was recorded.
+     */
+    std::uint64_t mean() const noexcept
+    {
+        return count ? sum_ns / count : 0;
+    }
+};
+
+/**
+ * @brief A lock-free latency histogram.
+ *
+ * @details Recording is a bucket lookup, three relaxed `fetch_add`s and a
+ * rarely-taken compare-exchange for the maximum. Readers copy the counters
+ * with relaxed loads, so a snapshot taken during recording may be off by
+ * the values in flight but is never torn per counter.
+ */
+class SignalHistogram
+{
+public:
+    /**
+     * @brief Records one value.
+     *
+     * @param value_ns The value in nanoseconds; negative values count as 0.
+     */
+    void record(std::int64_t value_ns) noexcept
+    {
+        std::uint64_t value = value_ns > 0 ? static_cast<std::uint64_t>(value_ns) : 0;
+
+        buckets[SignalHistogramSnapshot::bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        std::uint64_t seen = max.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !max.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Copies the current counters.
+     *
+     * @param out Receives the copy.
+     */
+    void snapshot(SignalHistogramSnapshot &out) const noexcept
+    {
+        out.count = count.load(std::memory_order_relaxed);
+        out.sum_ns = sum.load(std::memory_order_relaxed);
+        out.max_ns = max.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < SignalHistogramSnapshot::bucket_count; ++i)
+        {
+            out.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    /**
+     * @brief Number of recorded values.
+     */
+    std::atomic<std::uint64_t> count{0};
+
+    /**
+     * @brief Sum of recorded values, for the mean.
+     */
+    std::atomic<std::uint64_t> sum{0};
+
+    /**
+     * @brief Largest recorded value.
+     */
+    std::atomic<std::uint64_t> max{0};
+
+    /**
+     * @brief Per-bucket counts.
+     */
+    std::array<std::atomic<std::uint64_t>, SignalHistogramSnapshot::bucket_count> buckets{};
+};
+
+/**
+ * @brief Snapshot of the dispatch counters and per-signal histograms.
+ *
+ * @details Counter definitions:
+ * - `wakeups`: returns from `sigwaitinfo()` or signalfd reads that carried
+ *   at least one signal.
+ * - `received`: signal records taken from the kernel, excluding the
+ *   handler's own wake-up signal.
+ * - `dispatched`: records delivered to a handler or callback.
+ * - `dropped`: records received but delivered to nobody, because the
+ *   signal was no longer in the wait set or its handler was unregistered.
+ * - `batched`: records that arrived in the same wakeup as an earlier one,
+ *   i.e. whose wakeup cost was amortized. Coalescing of standard signals by
+ *   the kernel happens before the handler sees them and is not observable.
+ * - `suppressed`: records withheld by a `SignalThrottle` policy and never
+ *   delivered, because a newer record of the same signal replaced them.
+ */
+struct SignalStats
+{
+    /**
+     * @brief Counters and histograms for one signal number.
+     */
+    struct PerSignal
+    {
+        int signo = 0;                  ///< Signal number.
+        std::uint64_t received = 0;     ///< Records received for this signal.
+        std::uint64_t suppressed = 0;   ///< Records withheld by its throttle policy.
+        SignalHistogramSnapshot latency;  ///< Wakeup to handler entry.
+        SignalHistogramSnapshot duration; ///< Handler entry to return.
+    };
+
+    std::uint64_t wakeups = 0;    ///< Wakeups that carried signals.
+    std::uint64_t received = 0;   ///< Signal records received.
+    std::uint64_t dispatched = 0; ///< Records delivered to a handler.
+    std::uint64_t dropped = 0;    ///< Records received but not delivered.
+    std::uint64_t batched = 0;    ///< Records sharing a wakeup with an earlier one.
+    std::uint64_t suppressed = 0; ///< Records withheld by throttle policies.
+    std::vector<PerSignal> signals; ///< Signals seen at least once, by number.
+};
+
+/**
+ * @brief Dispatch-path instrumentation owned by SignalHandler.
+ *
+ * @details
+ * Per-signal histograms are allocated the first time a signal is recorded,
+ * so idle signals cost one null pointer each. Only the dispatching thread
+ * allocates; `snapshot()` may run on any thread at any time.
+ */
+class SignalMetrics
+{
+public:
+    /**
+     * @brief Number of per-signal slots (matches `_NSIG`).
+     */
+    static constexpr int slot_count = _NSIG;
+
+    SignalMetrics() = default;
+
+    // Owns the per-signal allocations
+    SignalMetrics(const SignalMetrics &) = delete;
+    SignalMetrics &operator=(const SignalMetrics &) = delete;
+
+    ~SignalMetrics()
+    {
+        for (auto &slot : slots)
+        {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Reads the monotonic clock (vDSO, no system call).
+     *
+     * @return Nanoseconds since an arbitrary epoch.
+     */
+    static std::int64_t now() noexcept
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    /**
+     * @brief Counts a wakeup and the records it carried.
+     *
+     * @param records Number of non-wake records received.
+     */
+    void onWakeup(std::size_t records) noexcept
+    {
+        if (records == 0)
+        {
+            return;
+        }
+
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        received.fetch_add(records, std::memory_order_relaxed);
+        batched.fetch_add(records - 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a received signal against its slot.
+     *
+     * @param signo The signal number.
+     */
+    void onReceived(int signo)
+    {
+        PerSignal *ps = slot(signo);
+        if (ps != nullptr)
+        {
+            ps->received.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Counts a record that was received but not delivered.
+     */
+    void onDropped() noexcept
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records one delivery.
+     *
+     * @param signo The signal number.
+     * @param woke_ns Timestamp taken when the wait returned.
+     * @param entry_ns Timestamp taken just before the handler was called.
+     * @param exit_ns Timestamp taken just after it returned.
+     */
+    void onDispatched(int signo, std::int64_t woke_ns, std::int64_t entry_ns, std::int64_t exit_ns)
+    {
+        dispatched.fetch_add(1, std::memory_order_relaxed);
+
+        PerSignal *ps = slot(signo);
+        if (ps != nullptr)
+        {
+            ps->latency.record(entry_ns - woke_ns);
+            ps->duration.record(exit_ns - entry_ns);
+        }
+    }
+
+    /**
+     * @brief Copies every counter and every allocated histogram.
+     *
+     * @param out Receives the snapshot.
+     */
+    void snapshot(SignalStats &out) const
+    {
+        out.wakeups = wakeups.load(std::memory_order_relaxed);
+        out.received = received.load(std::memory_order_relaxed);
+        out.dispatched = dispatched.load(std::memory_order_relaxed);
+        out.dropped = dropped.load(std::memory_order_relaxed);
+        out.batched = batched.load(std::memory_order_relaxed);
+
+        out.signals.clear();
+        for (int sig = 1; sig < slot_count; ++sig)
+        {
+            const PerSignal *ps = slots[sig].load(std::memory_order_acquire);
+            if (ps == nullptr)
+                continue;
+
+            out.signals.emplace_back();
+            SignalStats::PerSignal &entry = out.signals.back();
+            entry.signo = sig;
+            entry.received = ps->received.load(std::memory_order_relaxed);
+            ps->latency.snapshot(entry.latency);
+            ps->duration.snapshot(entry.duration);
+        }
+    }
+
+private:
+    /**
+     * @brief Live counters for one signal.
+     */
+    struct PerSignal
+    {
+        std::atomic<std::uint64_t> received{0};
+        SignalHistogram latency;
+        SignalHistogram duration;
+    };
+
+    /**
+     * @brief Returns a signal's slot, allocating it on first use.
+     *
+     * @param signo The signal number.
+     * @return The slot, or nullptr for an out-of-range signal.
+     */
+    PerSignal *slot(int signo)
+    {
+        if (signo <= 0 || signo >= slot_count)
+        {
+            return nullptr;
+        }
+
+        PerSignal *ps = slots[signo].load(std::memory_order_acquire);
+        if (ps != nullptr)
+        {
+            return ps;
+        }
+
+        // Another dispatching thread may race us; the loser frees its copy
+        PerSignal *fresh = new PerSignal;
+        if (slots[signo].compare_exchange_strong(ps, fresh, std::memory_order_acq_rel))
+        {
+            return fresh;
+        }
+        delete fresh;
+        return ps;
+    }
+
+    /**
+     * @brief Wakeups that carried signals.
+     */
+    std::atomic<std::uint64_t> wakeups{0};
+
+    /**
+     * @brief Signal records received.
+     */
+    std::atomic<std::uint64_t> received{0};
+
+    /**
+     * @brief Records delivered to a handler or callback.
+     */
+    std::atomic<std::uint64_t> dispatched{0};
+
+    /**
+     * @brief Records received but not delivered.
+     */
+    std::atomic<std::uint64_t> dropped{0};
+
+    /**
+     * @brief Records sharing a wakeup with an earlier one.
+     */
+    std::atomic<std::uint64_t> batched{0};
+
+    /**
+     * @brief Lazily allocated per-signal counters.
+     */
+    std::array<std::atomic<PerSignal *>, slot_count> slots{};
+};
+
+#endif // SIGNAL_STATS_HPP
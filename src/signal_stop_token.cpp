@@ -0,0 +1,121 @@
+/**
+ * @file signal_stop_token.cpp
+ * @brief Futex-based waiting for SignalStopSource.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_stop_token.hpp"
+
+// Standard libraries
+#include <climits>
+
+// System Libraries
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Thin wrapper over the futex syscall for a 32-bit atomic.
+ *
+ * @param word The atomic to wait on or wake.
+ * @param op FUTEX_WAIT_PRIVATE or FUTEX_WAKE_PRIVATE.
+ * @param val Expected value for a wait, or the number of waiters to wake.
+ * @param timeout Relative timeout for a wait, or nullptr.
+ * @return The raw syscall result.
+ */
+static long futex(const std::atomic<std::uint32_t> *word, int op,
+                  std::uint32_t val, const timespec *timeout)
+{
+    // std::atomic<uint32_t> is lock-free and layout-compatible with uint32_t
+    return syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(word),
+                   op, val, timeout, nullptr, 0);
+}
+
+/**
+ * @brief Requests a stop and wakes all waiters.
+ *
+ * @details
+ * Only the first request issues a `FUTEX_WAKE`; later calls are a single
+ * failed exchange. Safe to call from any thread, including the signal
+ * thread while workers are blocked in `wait()`.
+ *
+ * @return `true` if this call transitioned the source to stopped.
+ */
+bool SignalStopSource::requestStop() noexcept
+{
+    if (state.exchange(1, std::memory_order_acq_rel) != 0)
+    {
+        return false;
+    }
+
+    futex(&state, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+    return true;
+}
+
+/**
+ * @brief Blocks until a stop is requested.
+ *
+ * @details
+ * Sleeps in the kernel while the state is still 0. Spurious wake-ups and
+ * `EINTR` simply re-check the state.
+ */
+void SignalStopSource::wait() const noexcept
+{
+    while (state.load(std::memory_order_acquire) == 0)
+    {
+        futex(&state, FUTEX_WAIT_PRIVATE, 0, nullptr);
+    }
+}
+
+/**
+ * @brief Blocks until a stop is requested or the timeout elapses.
+ *
+ * @param timeout Maximum time to wait.
+ * @return `true` if a stop was requested, `false` on timeout.
+ */
+bool SignalStopSource::waitFor(std::chrono::nanoseconds timeout) const noexcept
+{
+    using clock = std::chrono::steady_clock;
+    const clock::time_point deadline = clock::now() + timeout;
+
+    while (state.load(std::memory_order_acquire) == 0)
+    {
+        auto remaining = deadline - clock::now();
+        if (remaining <= clock::duration::zero())
+        {
+            return false;
+        }
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        futex(&state, FUTEX_WAIT_PRIVATE, 0, &ts);
+    }
+
+    return true;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file signal_stop_token.hpp
+ * @brief A cache-line-aligned stop flag with futex-based waiting.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_STOP_TOKEN_HPP
+#define SIGNAL_STOP_TOKEN_HPP
+
+// Standard Libraries
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Owner side of a one-shot stop request.
+ *
+ * @details
+ * An equivalent of `std::stop_source` for C++17 builds. The state is a
+ * single 32-bit atomic padded to its own cache line, so workers polling it
+ * never share a line with anything the signal thread writes. Blocked
+ * threads sleep on the atomic itself through `futex(2)` rather than a
+ * mutex and condition variable.
+ */
+class alignas(64) SignalStopSource
+{
+public:
+    SignalStopSource() = default;
+
+    // Tokens refer to the source by address
+    SignalStopSource(const SignalStopSource &) = delete;
+    SignalStopSource &operator=(const SignalStopSource &) = delete;
+
+    /**
+     * @brief Reports whether a stop has been requested.
+     *
+     * @return true once `requestStop()` has been called.
+     */
+    bool stopRequested() const noexcept
+    {
+        return state.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Requests a stop and wakes every waiting thread.
+     *
+     * @return true if this call made the request, false if already requested.
+     */
+    bool requestStop() noexcept;
+
+    /**
+     * @brief Clears a previous stop request so the source can be reused.
+     */
+    void reset() noexcept
+    {
+        state.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Blocks until a stop is requested.
+     */
+    void wait() const noexcept;
+
+    /**
+     * @brief Blocks until a stop is requested or the timeout elapses.
+     *
+     * @param timeout Maximum time to wait.
+     * @return true if a stop was requested, false on timeout.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout) const noexcept;
+
+private:
+    /**
+     * @brief 0 while running, 1 once a stop has been requested.
+     */
+    std::atomic<std::uint32_t> state{0};
+};
+
+/**
+ * @brief Read-only view of a `SignalStopSource`, cheap to copy.
+ *
+ * @details An equivalent of `std::stop_token`. A default-constructed token
+ * never reports a stop and never blocks.
+ */
+class SignalStopToken
+{
+public:
+    SignalStopToken() = default;
+
+    /**
+     * @brief Creates a token observing the given source.
+     *
+     * @param src The source to observe; must outlive the token.
+     */
+    explicit SignalStopToken(const SignalStopSource &src) noexcept : source(&src) {}
+
+    /**
+     * @brief Reports whether a stop has been requested.
+     *
+     * @return true once the source has been triggered.
+     */
+    bool stopRequested() const noexcept
+    {
+        return source != nullptr && source->stopRequested();
+    }
+
+    /**
+     * @brief Reports whether this token is bound to a source.
+     *
+     * @return true if a stop can ever be observed through this token.
+     */
+    bool stopPossible() const noexcept
+    {
+        return source != nullptr;
+    }
+
+    /**
+     * @brief Blocks until a stop is requested.
+     */
+    void wait() const noexcept
+    {
+        if (source != nullptr)
+        {
+            source->wait();
+        }
+    }
+
+    /**
+     * @brief Blocks until a stop is requested or the timeout elapses.
+     *
+     * @param timeout Maximum time to wait.
+     * @return true if a stop was requested, false on timeout.
+     */
+    bool waitFor(std::chrono::nanoseconds timeout) const noexcept
+    {
+        return source != nullptr && source->waitFor(timeout);
+    }
+
+private:
+    /**
+     * @brief The observed source, or nullptr for an unbound token.
+     */
+    const SignalStopSource *source = nullptr;
+};
+
+#endif // SIGNAL_STOP_TOKEN_HPP
@@ -0,0 +1,377 @@
+/**
+ * @file signal_throttle.cpp
+ * @brief Per-signal debounce, token-bucket and latest-wins delivery policies.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_throttle.hpp"
+
+// Standard libraries
+#include <cmath>
+#include <cstring>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <cstdio> // For perror()
+#endif
+
+// Older C libraries only expose the union member
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/**
+ * @brief Destructor; deletes the release timers.
+ */
+SignalThrottle::~SignalThrottle()
+{
+    for (Slot &slot : slots)
+    {
+        if (slot.timer_created)
+        {
+            timer_delete(slot.timer);
+        }
+    }
+}
+
+/**
+ * @brief Sets a signal's policy.
+ *
+ * @details The mode is stored last, so the dispatching thread never sees
+ * a new mode with the old parameters.
+ *
+ * @param signo The signal.
+ * @param policy The policy.
+ * @return `true` if stored.
+ */
+bool SignalThrottle::set(int signo, const Policy &policy)
+{
+    if (signo <= 0 || signo >= slot_count)
+    {
+        return false;
+    }
+
+    std::int64_t period = 0;
+    std::int64_t tolerance = 0;
+    switch (policy.mode)
+    {
+    case Mode::None:
+    case Mode::LatestWins:
+        break;
+    case Mode::Debounce:
+        period = std::chrono::duration_cast<std::chrono::nanoseconds>(policy.window).count();
+        if (period <= 0)
+        {
+            return false;
+        }
+        break;
+    case Mode::RateLimit:
+        if (!(policy.rate > 0.0) || policy.burst == 0)
+        {
+            return false;
+        }
+        period = static_cast<std::int64_t>(std::llround(1e9 / policy.rate));
+        if (period <= 0)
+        {
+            period = 1;
+        }
+        tolerance = period * static_cast<std::int64_t>(policy.burst - 1);
+        break;
+    default:
+        return false;
+    }
+
+    Slot &slot = slots[signo];
+    slot.period_ns.store(period, std::memory_order_relaxed);
+    slot.tolerance_ns.store(tolerance, std::memory_order_relaxed);
+    auto latest = static_cast<std::uint8_t>(Mode::LatestWins);
+    std::uint8_t previous = slot.mode.exchange(static_cast<std::uint8_t>(policy.mode), std::memory_order_acq_rel);
+    if (previous != latest && policy.mode == Mode::LatestWins)
+    {
+        latest_wins.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (previous == latest && policy.mode != Mode::LatestWins)
+    {
+        latest_wins.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+/**
+ * @brief Applies the signal's policy to one record.
+ *
+ * @details A rate-limited record is only delivered at once if nothing is
+ * held; otherwise it would overtake the older held one.
+ *
+ * @param info The record.
+ * @param superseded A later record of the signal is in the batch.
+ * @param now_ns Current monotonic time.
+ * @param tick_signo Release tick signal.
+ * @param tid Release tick target.
+ * @return `true` to deliver now.
+ */
+bool SignalThrottle::admit(const siginfo_t &info, bool superseded, std::int64_t now_ns,
+                           int tick_signo, pid_t tid)
+{
+    Slot &slot = slots[info.si_signo];
+    auto mode = static_cast<Mode>(slot.mode.load(std::memory_order_acquire));
+    std::int64_t period = slot.period_ns.load(std::memory_order_relaxed);
+
+    switch (mode)
+    {
+    case Mode::LatestWins:
+        if (superseded)
+        {
+            slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+
+    case Mode::Debounce:
+        slot.due_ns = now_ns + period;
+        return !hold(slot, info, tick_signo, tid);
+
+    case Mode::RateLimit:
+    {
+        std::int64_t tolerance = slot.tolerance_ns.load(std::memory_order_relaxed);
+        if (!slot.held && slot.tat_ns - now_ns <= tolerance)
+        {
+            slot.tat_ns = (slot.tat_ns > now_ns ? slot.tat_ns : now_ns) + period;
+            return true;
+        }
+        slot.due_ns = slot.tat_ns - tolerance;
+        return !hold(slot, info, tick_signo, tid);
+    }
+
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief Reports whether `si_value` points into `slots`.
+ *
+ * @param info The record.
+ * @return `true` for a release tick.
+ */
+bool SignalThrottle::isTick(const siginfo_t &info) const noexcept
+{
+    if (info.si_code != SI_TIMER)
+    {
+        return false;
+    }
+
+    auto addr = reinterpret_cast<std::uintptr_t>(info.si_value.sival_ptr);
+    auto first = reinterpret_cast<std::uintptr_t>(slots.data());
+    auto last = reinterpret_cast<std::uintptr_t>(slots.data() + slots.size());
+    return addr >= first && addr < last;
+}
+
+/**
+ * @brief Releases the held record if it is due.
+ *
+ * @details A debounced signal that arrived again after the timer was set
+ * has a later `due_ns`, so the tick re-arms instead of releasing. Released
+ * rate-limited records take a token like any other delivery.
+ *
+ * @param tick The tick.
+ * @param out The record to deliver.
+ * @param now_ns Current monotonic time.
+ * @param tick_signo Release tick signal.
+ * @param tid Release tick target.
+ * @return `true` if `out` was filled.
+ */
+bool SignalThrottle::release(const siginfo_t &tick, siginfo_t &out, std::int64_t now_ns,
+                             int tick_signo, pid_t tid)
+{
+    Slot &slot = *static_cast<Slot *>(tick.si_value.sival_ptr);
+    if (now_ns >= slot.armed_ns)
+    {
+        slot.timer_set = false;
+    }
+
+    if (!slot.held)
+    {
+        return false;
+    }
+
+    if (now_ns < slot.due_ns)
+    {
+        if (!schedule(slot, tick_signo, tid))
+        {
+            slot.due_ns = now_ns; // No timer; release now rather than never
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (static_cast<Mode>(slot.mode.load(std::memory_order_relaxed)) == Mode::RateLimit)
+    {
+        std::int64_t period = slot.period_ns.load(std::memory_order_relaxed);
+        slot.tat_ns = (slot.tat_ns > now_ns ? slot.tat_ns : now_ns) + period;
+    }
+
+    out = slot.pending;
+    slot.held = false;
+    return true;
+}
+
+/**
+ * @brief Deletes the timers and discards held records.
+ */
+void SignalThrottle::disarm()
+{
+    for (Slot &slot : slots)
+    {
+        if (slot.held)
+        {
+            slot.held = false;
+            slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (slot.timer_created)
+        {
+            timer_delete(slot.timer);
+            slot.timer_created = false;
+        }
+        slot.timer_set = false;
+    }
+}
+
+/**
+ * @brief Forgets the parent's timers and held records.
+ *
+ * @details Timers are not inherited across `fork()`, so the handles are
+ * dropped without `timer_delete()`.
+ */
+void SignalThrottle::afterFork()
+{
+    for (Slot &slot : slots)
+    {
+        slot.held = false;
+        slot.timer_created = false;
+        slot.timer_set = false;
+    }
+}
+
+/**
+ * @brief Returns a signal's suppressed count.
+ *
+ * @param signo The signal.
+ * @return Records not delivered.
+ */
+std::uint64_t SignalThrottle::suppressed(int signo) const noexcept
+{
+    if (signo <= 0 || signo >= slot_count)
+    {
+        return 0;
+    }
+    return slots[signo].suppressed.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Holds the newest record for later release.
+ *
+ * @param slot The slot.
+ * @param info The record.
+ * @param tick_signo Release tick signal.
+ * @param tid Release tick target.
+ * @return `true` if held.
+ */
+bool SignalThrottle::hold(Slot &slot, const siginfo_t &info, int tick_signo, pid_t tid)
+{
+    if (!schedule(slot, tick_signo, tid))
+    {
+        return false;
+    }
+
+    // The record it replaces will never be delivered
+    if (slot.held)
+    {
+        slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.pending = info;
+    slot.held = true;
+    return true;
+}
+
+/**
+ * @brief Arms the release timer for `due_ns`.
+ *
+ * @details The timer is absolute on CLOCK_MONOTONIC, the clock the caller's
+ * timestamps come from. When it is already set to fire no later than
+ * `due_ns`, nothing is done: the early tick re-arms it for the rest.
+ *
+ * @param slot The slot.
+ * @param tick_signo Release tick signal.
+ * @param tid Release tick target.
+ * @return `true` if a tick will arrive by `due_ns`.
+ */
+bool SignalThrottle::schedule(Slot &slot, int tick_signo, pid_t tid)
+{
+    if (slot.timer_set && slot.armed_ns <= slot.due_ns)
+    {
+        return true;
+    }
+
+    if (!slot.timer_created)
+    {
+        sigevent sev;
+        std::memset(&sev, 0, sizeof(sev));
+        sev.sigev_notify = SIGEV_THREAD_ID;
+        sev.sigev_signo = tick_signo;
+        sev.sigev_value.sival_ptr = &slot;
+        sev.sigev_notify_thread_id = tid;
+        if (timer_create(CLOCK_MONOTONIC, &sev, &slot.timer) != 0)
+        {
+#ifdef DEBUG_SIGNAL_HANDLER
+            perror("timer_create");
+#endif
+            return false;
+        }
+        slot.timer_created = true;
+    }
+
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(slot.due_ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(slot.due_ns % 1000000000);
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+    {
+        spec.it_value.tv_nsec = 1; // Zero would disarm it
+    }
+    if (timer_settime(slot.timer, TIMER_ABSTIME, &spec, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_settime");
+#endif
+        return false;
+    }
+
+    slot.armed_ns = slot.due_ns;
+    slot.timer_set = true;
+    return true;
+}
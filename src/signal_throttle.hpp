@@ -0,0 +1,308 @@
+/**
+ * @file signal_throttle.hpp
+ * @brief Per-signal debounce, token-bucket and latest-wins delivery policies.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_THROTTLE_HPP
+#define SIGNAL_THROTTLE_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+
+// System libraries
+#include <sys/types.h>
+#include <time.h>
+
+/**
+ * @brief Collapses bursts of a signal into fewer deliveries.
+ *
+ * @details
+ * Each signal has its own policy:
+ * - `Debounce`: every record is held and restarts a quiet period; the
+ *   newest one is delivered once the signal has been quiet for `window`.
+ * - `RateLimit`: a token bucket of `burst` tokens refilled at `rate` per
+ *   second. A record that finds a token is delivered at once. Otherwise
+ *   it is held, replacing any older held record, and delivered when the
+ *   next token accrues.
+ * - `LatestWins`: of the records drained in one wakeup, only the last is
+ *   delivered. Queued real-time signals are the usual case; standard
+ *   signals are already coalesced by the kernel.
+ *
+ * With the first two modes, the newest record of a burst is always
+ * delivered eventually, so a reload storm ends with exactly one reload
+ * that sees the final state. Every record that is not delivered counts
+ * in `suppressed()`.
+ *
+ * The bucket is kept as a theoretical arrival time (GCRA), one timestamp
+ * and no floating point. Held records are released by a POSIX timer per
+ * signal that sends the tick signal to the dispatching thread with
+ * `si_value` pointing at the signal's slot. A timer is only re-armed when
+ * the release time moves earlier, so a storm costs one `timer_settime()`
+ * per quiet period rather than one per record.
+ *
+ * `set()` and `suppressed()` may be called from any thread. Everything
+ * else runs on the dispatching thread.
+ */
+class SignalThrottle
+{
+public:
+    /**
+     * @brief Number of per-signal slots (matches `_NSIG`).
+     */
+    static constexpr int slot_count = _NSIG;
+
+    /**
+     * @brief How a signal's records are admitted.
+     */
+    enum class Mode : std::uint8_t
+    {
+        None = 0,       ///< Deliver every record (the default).
+        Debounce = 1,   ///< Deliver the newest record after a quiet period.
+        RateLimit = 2,  ///< Token bucket; hold the newest excess record.
+        LatestWins = 3  ///< Deliver only the last record of each wakeup.
+    };
+
+    /**
+     * @brief A signal's policy and its parameters.
+     */
+    struct Policy
+    {
+        Mode mode = Mode::None;                  ///< The policy.
+        std::chrono::milliseconds window{0};     ///< Debounce quiet period.
+        double rate = 0.0;                       ///< RateLimit tokens per second.
+        std::uint32_t burst = 1;                 ///< RateLimit bucket size.
+
+        /**
+         * @brief Delivers every record.
+         *
+         * @return The policy.
+         */
+        static Policy none() noexcept
+        {
+            return Policy{};
+        }
+
+        /**
+         * @brief Delivers the newest record once `window` passes without another.
+         *
+         * @param window The quiet period.
+         * @return The policy.
+         */
+        static Policy debounce(std::chrono::milliseconds window) noexcept
+        {
+            Policy p;
+            p.mode = Mode::Debounce;
+            p.window = window;
+            return p;
+        }
+
+        /**
+         * @brief Delivers at most `per_second` records per second after a burst.
+         *
+         * @param per_second Refill rate.
+         * @param burst Records delivered back to back before limiting starts.
+         * @return The policy.
+         */
+        static Policy rateLimit(double per_second, std::uint32_t burst = 1) noexcept
+        {
+            Policy p;
+            p.mode = Mode::RateLimit;
+            p.rate = per_second;
+            p.burst = burst;
+            return p;
+        }
+
+        /**
+         * @brief Delivers only the last record of each wakeup.
+         *
+         * @return The policy.
+         */
+        static Policy latestWins() noexcept
+        {
+            Policy p;
+            p.mode = Mode::LatestWins;
+            return p;
+        }
+    };
+
+    SignalThrottle() = default;
+    ~SignalThrottle();
+
+    // Timers carry pointers into this object
+    SignalThrottle(const SignalThrottle &) = delete;
+    SignalThrottle &operator=(const SignalThrottle &) = delete;
+
+    /**
+     * @brief Sets a signal's policy.
+     *
+     * @details A policy change takes effect with the next record. A record
+     * held under the old policy is still released by its timer.
+     *
+     * @param signo The signal number.
+     * @param policy The policy.
+     * @return false for an invalid signal or parameters.
+     */
+    bool set(int signo, const Policy &policy);
+
+    /**
+     * @brief Reports whether a signal has a policy.
+     *
+     * @param signo A valid signal number.
+     * @return true unless the mode is `None`.
+     */
+    bool active(int signo) const noexcept
+    {
+        return slots[signo].mode.load(std::memory_order_relaxed) != static_cast<std::uint8_t>(Mode::None);
+    }
+
+    /**
+     * @brief Reports whether any signal uses `LatestWins`.
+     *
+     * @details The dispatcher then drains every pending record per wakeup,
+     * as in batch mode, so there is something to coalesce.
+     *
+     * @return true if at least one slot is in `LatestWins` mode.
+     */
+    bool coalescing() const noexcept
+    {
+        return latest_wins.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @brief Decides whether a record is delivered now.
+     *
+     * @param info The record.
+     * @param superseded Whether a later record of the same signal is in
+     *                   this wakeup's batch.
+     * @param now_ns CLOCK_MONOTONIC time in nanoseconds.
+     * @param tick_signo Signal for release timers.
+     * @param tid Thread release ticks are sent to.
+     * @return true to deliver it now, false if it was held or suppressed.
+     */
+    bool admit(const siginfo_t &info, bool superseded, std::int64_t now_ns, int tick_signo, pid_t tid);
+
+    /**
+     * @brief Reports whether a record is one of this throttle's release ticks.
+     *
+     * @param info The record.
+     * @return true if `si_value` points at one of the slots.
+     */
+    bool isTick(const siginfo_t &info) const noexcept;
+
+    /**
+     * @brief Handles a release tick.
+     *
+     * @param tick The tick record.
+     * @param out Receives the held record if it is due.
+     * @param now_ns CLOCK_MONOTONIC time in nanoseconds.
+     * @param tick_signo Signal for release timers.
+     * @param tid Thread release ticks are sent to.
+     * @return true if `out` should be delivered now.
+     */
+    bool release(const siginfo_t &tick, siginfo_t &out, std::int64_t now_ns, int tick_signo, pid_t tid);
+
+    /**
+     * @brief Deletes every timer and discards held records.
+     *
+     * @details Called when dispatching stops. Discarded records count as
+     * suppressed. Ticks already queued find nothing held.
+     */
+    void disarm();
+
+    /**
+     * @brief Forgets timers and held records in a forked child.
+     */
+    void afterFork();
+
+    /**
+     * @brief Returns how many of a signal's records were not delivered.
+     *
+     * @param signo The signal number.
+     * @return The count, or 0 for an invalid signal.
+     */
+    std::uint64_t suppressed(int signo) const noexcept;
+
+private:
+    /**
+     * @brief One signal's policy and dispatch-thread state.
+     */
+    struct Slot
+    {
+        // Written by `set()` from any thread
+        std::atomic<std::uint8_t> mode{0};           ///< `Mode` value.
+        std::atomic<std::int64_t> period_ns{0};      ///< Debounce window, or ns per token.
+        std::atomic<std::int64_t> tolerance_ns{0};   ///< (burst - 1) periods.
+
+        // Dispatching thread only
+        std::int64_t tat_ns = 0;      ///< Theoretical arrival time of the next token.
+        std::int64_t due_ns = 0;      ///< When the held record may be released.
+        std::int64_t armed_ns = 0;    ///< Expiry the timer is set for.
+        bool held = false;            ///< `pending` is waiting for release.
+        bool timer_set = false;       ///< `armed_ns` is in the future.
+        bool timer_created = false;   ///< `timer` exists.
+        timer_t timer{};              ///< Release timer.
+        siginfo_t pending{};          ///< Newest suppressed record.
+
+        std::atomic<std::uint64_t> suppressed{0}; ///< Records not delivered.
+    };
+
+    /**
+     * @brief Holds a record until `due_ns`, replacing any held one.
+     *
+     * @param slot The signal's slot.
+     * @param info The record.
+     * @param tick_signo Signal for the release timer.
+     * @param tid Thread the tick is sent to.
+     * @return false if no timer could be armed; the record is then not held.
+     */
+    bool hold(Slot &slot, const siginfo_t &info, int tick_signo, pid_t tid);
+
+    /**
+     * @brief Arms the slot's timer for `due_ns` unless it fires sooner.
+     *
+     * @param slot The signal's slot.
+     * @param tick_signo Signal for the release timer.
+     * @param tid Thread the tick is sent to.
+     * @return false if the timer could not be created or set.
+     */
+    bool schedule(Slot &slot, int tick_signo, pid_t tid);
+
+    /**
+     * @brief Per-signal slots, indexed by signal number.
+     */
+    std::array<Slot, slot_count> slots{};
+
+    /**
+     * @brief Number of slots in `LatestWins` mode.
+     */
+    std::atomic<int> latest_wins{0};
+};
+
+#endif // SIGNAL_THROTTLE_HPP
@@ -0,0 +1,359 @@
+/**
+ * @file signal_watchdog.cpp
+ * @brief Heartbeat watchdog that reports stalled threads from the signal thread.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Project libraries
+#include "signal_watchdog.hpp"
+#include "signal_backtrace.hpp"
+
+// Standard libraries
+#include <cstring>
+#include <new>
+
+// System libraries
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef DEBUG_SIGNAL_HANDLER
+#include <cstdio> // For perror()
+#endif
+
+// Older C libraries only expose the union member
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ *
+ * @return The current time.
+ */
+static std::int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Constructs a watchdog with no threads and no timer.
+ */
+SignalWatchdog::SignalWatchdog()
+    : timer(),
+      timer_armed(false),
+      backtraces(false),
+      tick_count(0),
+      stall_count(0)
+{
+}
+
+/**
+ * @brief Destructor; deletes the timer.
+ */
+SignalWatchdog::~SignalWatchdog()
+{
+    disarm();
+}
+
+/**
+ * @brief Starts monitoring the calling thread.
+ *
+ * @details The slot's fields are written first and published by making
+ * its generation odd, so the scanner never sees a half-registered thread.
+ *
+ * @param name Reported name.
+ * @param stall_after Stall threshold.
+ * @return The slot, or -1 if full.
+ */
+int SignalWatchdog::registerThread(const char *name, std::chrono::milliseconds stall_after)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::size_t i = 0; i < max_threads; ++i)
+    {
+        Slot &slot = slots[i];
+        std::uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        if ((generation & 1) != 0)
+        {
+            continue;
+        }
+
+        slot.tid = static_cast<pid_t>(syscall(SYS_gettid));
+        slot.stall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stall_after).count();
+        std::memset(slot.name, 0, sizeof(slot.name));
+        if (name != nullptr)
+        {
+            std::strncpy(slot.name, name, sizeof(slot.name) - 1);
+        }
+        slot.generation.store(generation + 1, std::memory_order_release);
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+/**
+ * @brief Stops monitoring a thread.
+ *
+ * @param slot The slot; ignored if negative or free.
+ */
+void SignalWatchdog::unregisterThread(int slot)
+{
+    if (slot < 0 || static_cast<std::size_t>(slot) >= max_threads)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint32_t generation = slots[slot].generation.load(std::memory_order_relaxed);
+    if ((generation & 1) != 0)
+    {
+        slots[slot].generation.store(generation + 1, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Sets the handler for stalled threads.
+ *
+ * @param handler The handler.
+ */
+void SignalWatchdog::setStallHandler(const StallHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stall_handler = handler;
+}
+
+/**
+ * @brief Enables or disables backtrace capture.
+ *
+ * @param enable Whether to capture backtraces.
+ * @return `true` unless no real-time signal was free.
+ */
+bool SignalWatchdog::enableBacktraces(bool enable)
+{
+    if (enable && !SignalBacktrace::enable())
+    {
+        return false;
+    }
+    backtraces.store(enable);
+    return true;
+}
+
+/**
+ * @brief Starts or re-arms the tick timer.
+ *
+ * @details The timer uses CLOCK_MONOTONIC and `SIGEV_THREAD_ID`, so every
+ * tick reaches `tid` alone with `si_value` pointing at this watchdog.
+ *
+ * @param signo The tick signal.
+ * @param tid The target thread.
+ * @param interval Time between ticks.
+ * @return `true` if armed.
+ */
+bool SignalWatchdog::arm(int signo, pid_t tid, std::chrono::milliseconds interval)
+{
+    if (interval <= std::chrono::milliseconds::zero() || tid <= 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (timer_armed)
+    {
+        timer_delete(timer);
+        timer_armed = false;
+    }
+
+    sigevent sev;
+    std::memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = signo;
+    sev.sigev_value.sival_ptr = this;
+    sev.sigev_notify_thread_id = tid;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timer) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_create");
+#endif
+        return false;
+    }
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+    itimerspec spec;
+    spec.it_interval.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_interval.tv_nsec = static_cast<long>(ns % 1000000000);
+    spec.it_value = spec.it_interval;
+    if (timer_settime(timer, 0, &spec, nullptr) != 0)
+    {
+#ifdef DEBUG_SIGNAL_HANDLER
+        perror("timer_settime");
+#endif
+        timer_delete(timer);
+        return false;
+    }
+
+    timer_armed = true;
+    return true;
+}
+
+/**
+ * @brief Deletes the tick timer.
+ *
+ * @details Ticks already queued are still delivered; `isTick()` then
+ * matches them and `scan()` is harmless.
+ */
+void SignalWatchdog::disarm()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (timer_armed)
+    {
+        timer_delete(timer);
+        timer_armed = false;
+    }
+}
+
+/**
+ * @brief Reports whether the tick timer exists.
+ *
+ * @return `true` while armed.
+ */
+bool SignalWatchdog::armed() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return timer_armed;
+}
+
+/**
+ * @brief Forgets the timer and every slot in a forked child.
+ */
+void SignalWatchdog::afterFork()
+{
+    // A thread that held it at the fork is gone
+    new (&mutex) std::mutex();
+
+    timer_armed = false;
+    for (Slot &slot : slots)
+    {
+        std::uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        if ((generation & 1) != 0)
+        {
+            slot.generation.store(generation + 1, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Checks every slot and reports new stalls.
+ *
+ * @details
+ * A slot whose generation changed since the last scan is (re)initialized
+ * with the current counter and time. Otherwise an unchanged counter older
+ * than the slot's threshold is a stall, reported once until the counter
+ * moves again. The handler runs without the lock held.
+ *
+ * @return The number of stalls reported.
+ */
+std::size_t SignalWatchdog::scan()
+{
+    tick_count.fetch_add(1, std::memory_order_relaxed);
+
+    StallHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handler = stall_handler;
+    }
+
+    std::int64_t now = monotonicNs();
+    std::size_t reported = 0;
+    for (std::size_t i = 0; i < max_threads; ++i)
+    {
+        Slot &slot = slots[i];
+        std::uint32_t generation = slot.generation.load(std::memory_order_acquire);
+        if ((generation & 1) == 0)
+        {
+            continue;
+        }
+
+        std::uint64_t count = beats[i].count.load(std::memory_order_acquire);
+        if (generation != slot.seen_generation || count != slot.last_count)
+        {
+            slot.seen_generation = generation;
+            slot.last_count = count;
+            slot.last_change_ns = now;
+            slot.reported = false;
+            continue;
+        }
+
+        if (slot.reported || now - slot.last_change_ns < slot.stall_ns)
+        {
+            continue;
+        }
+        slot.reported = true;
+
+        slot.depth = 0;
+        if (backtraces.load(std::memory_order_relaxed))
+        {
+            slot.depth = SignalBacktrace::capture(slot.tid, slot.frames, max_frames, trace_timeout);
+        }
+        bool traced = slot.depth > 0;
+
+        Stall stall;
+        stall.slot = static_cast<int>(i);
+        stall.tid = slot.tid;
+        stall.name = slot.name;
+        stall.beats = count;
+        stall.stalled_ns = now - slot.last_change_ns;
+        stall.frames = traced ? slot.frames : nullptr;
+        stall.depth = traced ? slot.depth : 0;
+
+        stall_count.fetch_add(1, std::memory_order_relaxed);
+        ++reported;
+        if (handler)
+        {
+            handler(stall);
+        }
+    }
+    return reported;
+}
+
+/**
+ * @brief Returns the number of ticks scanned.
+ *
+ * @return The tick count.
+ */
+std::uint64_t SignalWatchdog::ticks() const noexcept
+{
+    return tick_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of stalls reported.
+ *
+ * @return The stall count.
+ */
+std::uint64_t SignalWatchdog::stalls() const noexcept
+{
+    return stall_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,302 @@
+/**
+ * @file signal_watchdog.hpp
+ * @brief Heartbeat watchdog that reports stalled threads from the signal thread.
+ *
+ * This software is distributed under the MIT License. See LICENSE.md for
+ * details.
+ *
+ * Copyright (C) 2025 Lee C. Bussy (@LBussy). All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIGNAL_WATCHDOG_HPP
+#define SIGNAL_WATCHDOG_HPP
+
+// Standard Libraries
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// System libraries
+#include <sys/types.h>
+#include <time.h>
+
+// Project libraries
+#include "signal_function.hpp"
+
+/**
+ * @brief Detects threads that stop making progress.
+ *
+ * @details
+ * Each monitored thread claims a slot with `registerThread()` and calls
+ * `beat()` from its loop. A beat is one relaxed load and one release store
+ * to a counter on the thread's own cache line, so beating costs about as
+ * much as an uncontended store and never touches shared state.
+ *
+ * A POSIX per-process timer (`timer_create()` with `SIGEV_THREAD_ID`)
+ * delivers a tick signal to one thread, the SignalHandler's dispatching
+ * thread when bound with `SignalHandler::enableWatchdog()`. Each tick calls
+ * `scan()`, which compares every counter with its value at the last change.
+ * A thread whose counter has not moved for its stall threshold is reported
+ * once to the stall handler, and again only after it has beaten and
+ * stalled anew.
+ *
+ * With backtraces enabled, the scanner first captures the stalled thread's
+ * stack with `SignalBacktrace`, a directed signal whose handler runs on
+ * that thread, waiting at most `trace_timeout`. A thread with that signal
+ * blocked, or stuck in the kernel with no way to run the handler, is
+ * reported without frames.
+ */
+class SignalWatchdog
+{
+public:
+    /**
+     * @brief Maximum number of monitored threads.
+     */
+    static constexpr std::size_t max_threads = 64;
+
+    /**
+     * @brief Maximum number of frames captured per stalled thread.
+     */
+    static constexpr int max_frames = 32;
+
+    /**
+     * @brief How long `scan()` waits for a stalled thread's backtrace.
+     */
+    static constexpr std::chrono::milliseconds trace_timeout{20};
+
+    /**
+     * @brief One stalled thread, as passed to the stall handler.
+     */
+    struct Stall
+    {
+        int slot;                 ///< The thread's slot.
+        pid_t tid;                ///< Kernel thread ID.
+        const char *name;         ///< Name given at registration.
+        std::uint64_t beats;      ///< Heartbeats counted so far.
+        std::int64_t stalled_ns;  ///< Time since the last heartbeat.
+        void *const *frames;      ///< Captured return addresses, or nullptr.
+        int depth;                ///< Number of entries in `frames`.
+    };
+
+    /**
+     * @brief Called on the scanning thread for each newly stalled thread.
+     *
+     * @details `frames` may be printed with `backtrace_symbols_fd()`.
+     */
+    using StallHandler = SignalInplaceFunction<void(const Stall &stall)>;
+
+    SignalWatchdog();
+    ~SignalWatchdog();
+
+    // The timer and the trace signal carry pointers into this object
+    SignalWatchdog(const SignalWatchdog &) = delete;
+    SignalWatchdog &operator=(const SignalWatchdog &) = delete;
+
+    /**
+     * @brief Starts monitoring the calling thread.
+     *
+     * @param name Short name reported on a stall; copied, up to 15 characters.
+     * @param stall_after Time without a heartbeat before the thread counts as stalled.
+     * @return The slot to pass to `beat()`, or -1 if every slot is taken.
+     */
+    int registerThread(const char *name, std::chrono::milliseconds stall_after);
+
+    /**
+     * @brief Stops monitoring a thread.
+     *
+     * @param slot The slot from `registerThread()`; ignored if negative.
+     */
+    void unregisterThread(int slot);
+
+    /**
+     * @brief Records progress; call from the registered thread only.
+     *
+     * @param slot The calling thread's slot.
+     */
+    void beat(int slot) noexcept
+    {
+        Beat &b = beats[static_cast<std::size_t>(slot)];
+        b.count.store(b.count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Sets the handler for stalled threads.
+     *
+     * @param handler The handler; set it before arming the timer.
+     */
+    void setStallHandler(const StallHandler &handler);
+
+    /**
+     * @brief Captures stalled threads' stacks before reporting them.
+     *
+     * @details The first call runs `SignalBacktrace::enable()`, which
+     * claims a free real-time signal for the process.
+     *
+     * @param enable Whether to capture backtraces.
+     * @return false if no real-time signal was free.
+     */
+    bool enableBacktraces(bool enable = true);
+
+    /**
+     * @brief Starts the tick timer.
+     *
+     * @details Re-arming an armed watchdog changes the target and interval.
+     *
+     * @param signo Signal the timer delivers; must be in the target's wait set.
+     * @param tid Kernel thread ID the ticks are directed at.
+     * @param interval Time between ticks.
+     * @return false if the timer could not be created.
+     */
+    bool arm(int signo, pid_t tid, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Deletes the tick timer.
+     */
+    void disarm();
+
+    /**
+     * @brief Reports whether the tick timer exists.
+     *
+     * @return true while armed.
+     */
+    bool armed() const;
+
+    /**
+     * @brief Forgets the timer and every thread in a child after `fork()`.
+     *
+     * @details Timers are not inherited and only the forking thread exists,
+     * so the child starts with no slots; threads there register again.
+     */
+    void afterFork();
+
+    /**
+     * @brief Reports whether a received signal is one of this watchdog's ticks.
+     *
+     * @param info The signal.
+     * @return true for a tick from the armed timer.
+     */
+    bool isTick(const siginfo_t &info) const noexcept
+    {
+        return info.si_code == SI_TIMER && info.si_value.sival_ptr == this;
+    }
+
+    /**
+     * @brief Checks every slot and reports new stalls; called on each tick.
+     *
+     * @details Single scanner: call from one thread only.
+     *
+     * @return The number of stalls reported.
+     */
+    std::size_t scan();
+
+    /**
+     * @brief Returns the number of ticks scanned.
+     *
+     * @return The tick count.
+     */
+    std::uint64_t ticks() const noexcept;
+
+    /**
+     * @brief Returns the number of stalls reported.
+     *
+     * @return The stall count.
+     */
+    std::uint64_t stalls() const noexcept;
+
+private:
+    /**
+     * @brief A thread's heartbeat counter, alone on its cache line.
+     */
+    struct alignas(64) Beat
+    {
+        std::atomic<std::uint64_t> count{0};
+    };
+
+    /**
+     * @brief Registration and scanner state for one thread.
+     */
+    struct Slot
+    {
+        std::atomic<std::uint32_t> generation{0}; ///< Odd while registered.
+        pid_t tid = 0;                            ///< Kernel thread ID.
+        std::int64_t stall_ns = 0;                ///< Stall threshold.
+        char name[16] = {};                       ///< Reported name.
+
+        // Owned by the scanner
+        std::uint32_t seen_generation = 0;        ///< Generation the fields below track.
+        std::uint64_t last_count = 0;             ///< Counter at the last change.
+        std::int64_t last_change_ns = 0;          ///< When it last changed.
+        bool reported = false;                    ///< Current stall already reported.
+        int depth = 0;                            ///< Captured frame count.
+        void *frames[max_frames] = {};            ///< Captured frames.
+    };
+
+    /**
+     * @brief Heartbeat counters, one cache line each.
+     */
+    std::array<Beat, max_threads> beats;
+
+    /**
+     * @brief Registration and scanner state, parallel to `beats`.
+     */
+    std::array<Slot, max_threads> slots;
+
+    /**
+     * @brief Serializes registration, handler changes and the timer.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Handler for newly stalled threads.
+     */
+    StallHandler stall_handler;
+
+    /**
+     * @brief The tick timer, valid while `timer_armed`.
+     */
+    timer_t timer;
+
+    /**
+     * @brief Whether `timer` exists.
+     */
+    bool timer_armed;
+
+    /**
+     * @brief Whether stalls are reported with backtraces.
+     */
+    std::atomic<bool> backtraces;
+
+    /**
+     * @brief Ticks scanned.
+     */
+    std::atomic<std::uint64_t> tick_count;
+
+    /**
+     * @brief Stalls reported.
+     */
+    std::atomic<std::uint64_t> stall_count;
+};
+
+#endif // SIGNAL_WATCHDOG_HPP